@@ -0,0 +1,447 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmarks of milia
+ *
+ * Times dl, da, dc, vol, age and lt for one cosmology of each
+ * computation case, with milia::flrw_nat (scalar, array and parallel
+ * versions) and milia::rei::flrw_nat (scalar), the construction of
+ * both, set_matter and set_vacuum, and the numerical integration of
+ * the age (the fallback of the analytic ages), one redshift at a time
+ * and cumulative over the array.
+ *
+ * Each benchmark evaluates an array of redshifts reps times, after one
+ * untimed pass. The results are written to standard output, one record
+ * per benchmark, as CSV or JSON, with the minimum and the median time
+ * per element (the latency of the scalar versions) and the throughput
+ * at the median.
+ *
+ * Usage: milia_bench [--json] [--size n] [--reps n] [--threads n]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "milia/flrw_nat.h"
+#include "milia/flrw.h"
+#include "milia/parallel.h"
+#include "milia/quadrature.h"
+#include "milia/util.h"
+#include "milia/flrw_prec.h"
+
+#ifndef PACKAGE_VERSION
+#define PACKAGE_VERSION "unknown"
+#endif
+
+namespace
+{
+  // One cosmology of each computation case
+  struct cosmology
+  {
+      const char* name;
+      double matter;
+      double vacuum;
+  };
+
+  const cosmology COSMOLOGIES[] = { { "OM_OV_0", 0, 0 },
+      { "OV_1", 0.3, 0 }, { "OV_2", 2, 0 }, { "OV_EDS", 1, 0 }, { "OM", 0,
+          0.7 }, { "OM_DS", 0, 1 }, { "OM_OV_1", 0.3, 0.7 }, { "A1", 0.3,
+          0.3 }, { "A2_1", 2, 0.041889066001582084 }, { "A2_2", 3, 0.1 } };
+  const std::size_t NCOSMO = sizeof(COSMOLOGIES) / sizeof(COSMOLOGIES[0]);
+
+  struct options
+  {
+      std::size_t size;
+      int reps;
+      unsigned threads;
+      bool json;
+  };
+
+  // Elapsed time in seconds from an arbitrary origin
+  double now()
+  {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+  }
+
+  // Redshifts in [0.01, 10], equally spaced in log(1 + z) and shuffled
+  // with a fixed sequence, as those of a catalogue
+  std::vector<double> redshifts(std::size_t n)
+  {
+    std::vector<double> z(n);
+    const double lmin = std::log(1.01);
+    const double lmax = std::log(11.);
+    for (std::size_t i = 0; i < n; ++i)
+      z[i] = std::exp(lmin + (lmax - lmin) * i / std::max<std::size_t>(n - 1,
+          1)) - 1;
+    unsigned long state = 12345;
+    for (std::size_t i = n; i > 1; --i)
+    {
+      state = (1103515245 * state + 12345) % 2147483648UL;
+      std::swap(z[i - 1], z[state % i]);
+    }
+    return z;
+  }
+
+  // Writes the records as CSV or as a JSON object
+  class report
+  {
+    public:
+      report(const options& opt) :
+        m_json(opt.json), m_count(0)
+      {
+        if (m_json)
+          std::printf("{\n  \"version\": \"%s\",\n  \"size\": %lu,\n"
+            "  \"reps\": %d,\n  \"threads\": %u,\n  \"results\": [",
+              PACKAGE_VERSION, static_cast<unsigned long> (opt.size),
+              opt.reps, opt.threads);
+        else
+          std::printf("version,implementation,case,quantity,mode,n,"
+            "min_ns,median_ns,per_second,status\n");
+      }
+
+      ~report()
+      {
+        if (m_json)
+          std::printf("\n  ]\n}\n");
+      }
+
+      // Times per element in ns, status is "ok" or the error message
+      void add(const char* impl, const char* cosmo, const char* quantity,
+          const char* mode, std::size_t n, double min_ns, double median_ns,
+          const std::string& status)
+      {
+        const double rate = median_ns > 0 ? 1e9 / median_ns : 0;
+        if (m_json)
+          std::printf("%s\n    {\"implementation\": \"%s\", \"case\": \"%s\", "
+            "\"quantity\": \"%s\", \"mode\": \"%s\", \"n\": %lu, "
+            "\"min_ns\": %.4g, \"median_ns\": %.4g, \"per_second\": %.6g, "
+            "\"status\": \"%s\"}", m_count ? "," : "", impl, cosmo,
+              quantity, mode, static_cast<unsigned long> (n), min_ns,
+              median_ns, rate, escape(status).c_str());
+        else
+          std::printf("%s,%s,%s,%s,%s,%lu,%.4g,%.4g,%.6g,\"%s\"\n",
+              PACKAGE_VERSION, impl, cosmo, quantity, mode,
+              static_cast<unsigned long> (n), min_ns, median_ns, rate,
+              escape(status).c_str());
+        std::fflush(stdout);
+        ++m_count;
+      }
+
+    private:
+      // The messages of the exceptions, without quotes
+      static std::string escape(const std::string& s)
+      {
+        std::string r(s);
+        std::replace(r.begin(), r.end(), '"', '\'');
+        return r;
+      }
+
+      bool m_json;
+      std::size_t m_count;
+  };
+
+  // Runs body once untimed and reps times timed, body evaluates n
+  // elements
+  template<class Body>
+  void measure(report& rep, const options& opt, const char* impl,
+      const char* cosmo, const char* quantity, const char* mode,
+      std::size_t n, Body& body)
+  {
+    std::vector<double> times;
+    try
+    {
+      body();
+      for (int r = 0; r < opt.reps; ++r)
+      {
+        const double t0 = now();
+        body();
+        times.push_back((now() - t0) * 1e9 / n);
+      }
+    }
+    catch (const std::exception& e)
+    {
+      rep.add(impl, cosmo, quantity, mode, n, 0, 0, e.what());
+      return;
+    }
+    std::sort(times.begin(), times.end());
+    rep.add(impl, cosmo, quantity, mode, n, times.front(),
+        times[times.size() / 2], "ok");
+  }
+
+  // The results are summed, so that the calls are not optimized away
+  template<class Metric>
+  struct scalar_body
+  {
+      typedef double (Metric::*method_type)(double) const;
+      const Metric& metric;
+      method_type method;
+      const std::vector<double>& z;
+      double sink;
+
+      void operator()()
+      {
+        for (std::size_t i = 0; i < z.size(); ++i)
+          sink += (metric.*method)(z[i]);
+      }
+  };
+
+  template<class Metric>
+  struct array_body
+  {
+      typedef void (Metric::*method_type)(const double*, double*,
+          std::size_t) const;
+      const Metric& metric;
+      method_type method;
+      const std::vector<double>& z;
+      std::vector<double>& res;
+
+      void operator()()
+      {
+        (metric.*method)(&z[0], &res[0], z.size());
+      }
+  };
+
+  template<class Metric>
+  struct parallel_body
+  {
+      typedef void (Metric::*method_type)(const double*, double*,
+          std::size_t) const;
+      milia::thread_pool& pool;
+      const Metric& metric;
+      method_type method;
+      const std::vector<double>& z;
+      std::vector<double>& res;
+
+      void operator()()
+      {
+        milia::parallel(pool, metric, method, &z[0], &res[0], z.size());
+      }
+  };
+
+  template<class Metric>
+  struct construct_body
+  {
+      double matter;
+      double vacuum;
+      std::size_t n;
+      double sink;
+
+      void operator()()
+      {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          const Metric m(matter, vacuum);
+          sink += m.get_matter();
+        }
+      }
+  };
+
+  // set_matter or set_vacuum with the current value, the invariants
+  // are computed again
+  struct setter_body
+  {
+      milia::flrw_nat& metric;
+      bool matter;
+      std::size_t n;
+
+      void operator()()
+      {
+        const double om = metric.get_matter();
+        const double ov = metric.get_vacuum();
+        for (std::size_t i = 0; i < n; ++i)
+          if (matter)
+            metric.set_matter(om);
+          else
+            metric.set_vacuum(ov);
+      }
+  };
+
+  // The integral of the age, the reference of the closed forms
+  struct quadrature_body
+  {
+      milia::age_integrand f;
+      const std::vector<double>& z;
+      double sink;
+
+      void operator()()
+      {
+        for (std::size_t i = 0; i < z.size(); ++i)
+          sink += milia::quadrature::upper(f, z[i], FLRW_QUAD_TOL);
+      }
+  };
+
+  struct cumulative_body
+  {
+      milia::age_integrand f;
+      const std::vector<double>& z;
+      std::vector<double>& res;
+
+      void operator()()
+      {
+        milia::quadrature::cumulative_upper(f, &z[0], &res[0], z.size(),
+            FLRW_QUAD_TOL);
+      }
+  };
+
+  const char* const QUANTITIES[] = { "dl", "da", "dc", "vol", "age", "lt" };
+  const std::size_t NQUANT = sizeof(QUANTITIES) / sizeof(QUANTITIES[0]);
+
+  typedef double (milia::flrw_nat::*nat_scalar)(double) const;
+  typedef void (milia::flrw_nat::*nat_array)(const double*, double*,
+      std::size_t) const;
+  typedef double (milia::rei::flrw_nat::*rei_scalar)(double) const;
+
+  const nat_scalar NAT_SCALAR[] = { &milia::flrw_nat::dl,
+      &milia::flrw_nat::da, &milia::flrw_nat::dc, &milia::flrw_nat::vol,
+      &milia::flrw_nat::age, &milia::flrw_nat::lt };
+  const nat_array NAT_ARRAY[] = { &milia::flrw_nat::dl, &milia::flrw_nat::da,
+      &milia::flrw_nat::dc, &milia::flrw_nat::vol, &milia::flrw_nat::age,
+      &milia::flrw_nat::lt };
+  const rei_scalar REI_SCALAR[] = { &milia::rei::flrw_nat::dl,
+      &milia::rei::flrw_nat::da, &milia::rei::flrw_nat::dc,
+      &milia::rei::flrw_nat::vol, &milia::rei::flrw_nat::age,
+      &milia::rei::flrw_nat::lt };
+
+  void bench_flrw_nat(report& rep, const options& opt,
+      milia::thread_pool& pool, const cosmology& c,
+      const std::vector<double>& z, std::vector<double>& res)
+  {
+    const char* impl = "flrw_nat";
+    construct_body<milia::flrw_nat> cb = { c.matter, c.vacuum, z.size(), 0 };
+    measure(rep, opt, impl, c.name, "construct", "scalar", z.size(), cb);
+
+    milia::flrw_nat metric(c.matter, c.vacuum);
+    setter_body sm = { metric, true, z.size() };
+    measure(rep, opt, impl, c.name, "set_matter", "scalar", z.size(), sm);
+    setter_body sv = { metric, false, z.size() };
+    measure(rep, opt, impl, c.name, "set_vacuum", "scalar", z.size(), sv);
+
+    for (std::size_t q = 0; q < NQUANT; ++q)
+    {
+      scalar_body<milia::flrw_nat> sb = { metric, NAT_SCALAR[q], z, 0 };
+      measure(rep, opt, impl, c.name, QUANTITIES[q], "scalar", z.size(), sb);
+      array_body<milia::flrw_nat> ab = { metric, NAT_ARRAY[q], z, res };
+      measure(rep, opt, impl, c.name, QUANTITIES[q], "array", z.size(), ab);
+      parallel_body<milia::flrw_nat> pb =
+          { pool, metric, NAT_ARRAY[q], z, res };
+      measure(rep, opt, impl, c.name, QUANTITIES[q], "parallel", z.size(),
+          pb);
+    }
+  }
+
+  void bench_rei(report& rep, const options& opt, const cosmology& c,
+      const std::vector<double>& z)
+  {
+    const char* impl = "rei::flrw_nat";
+    construct_body<milia::rei::flrw_nat> cb =
+        { c.matter, c.vacuum, z.size(), 0 };
+    measure(rep, opt, impl, c.name, "construct", "scalar", z.size(), cb);
+
+    // The constructor throws for the densities it does not accept
+    try
+    {
+      const milia::rei::flrw_nat metric(c.matter, c.vacuum);
+      for (std::size_t q = 0; q < NQUANT; ++q)
+      {
+        scalar_body<milia::rei::flrw_nat> sb =
+            { metric, REI_SCALAR[q], z, 0 };
+        measure(rep, opt, impl, c.name, QUANTITIES[q], "scalar", z.size(),
+            sb);
+      }
+    }
+    catch (const std::exception& e)
+    {
+      for (std::size_t q = 0; q < NQUANT; ++q)
+        rep.add(impl, c.name, QUANTITIES[q], "scalar", z.size(), 0, 0,
+            e.what());
+    }
+  }
+
+  void bench_quadrature(report& rep, const options& opt, const cosmology& c,
+      const std::vector<double>& z, std::vector<double>& res)
+  {
+    const char* impl = "quadrature";
+    const milia::age_integrand f = { c.matter, c.vacuum };
+    quadrature_body qb = { f, z, 0 };
+    measure(rep, opt, impl, c.name, "age", "scalar", z.size(), qb);
+    cumulative_body cb = { f, z, res };
+    measure(rep, opt, impl, c.name, "age", "cumulative", z.size(), cb);
+  }
+
+  bool parse(int argc, char** argv, options& opt)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const char* arg = argv[i];
+      if (std::strcmp(arg, "--json") == 0)
+        opt.json = true;
+      else if (std::strcmp(arg, "--csv") == 0)
+        opt.json = false;
+      else if (i + 1 < argc && std::strcmp(arg, "--size") == 0)
+        opt.size = std::strtoul(argv[++i], 0, 10);
+      else if (i + 1 < argc && std::strcmp(arg, "--reps") == 0)
+        opt.reps = std::atoi(argv[++i]);
+      else if (i + 1 < argc && std::strcmp(arg, "--threads") == 0)
+        opt.threads = std::strtoul(argv[++i], 0, 10);
+      else
+        return false;
+    }
+    return opt.size > 0 && opt.reps > 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  options opt = { 16384, 7, 0, false };
+  if (!parse(argc, argv, opt))
+  {
+    std::fprintf(stderr, "Usage: %s [--json | --csv] [--size n] [--reps n]"
+      " [--threads n]\n", argv[0]);
+    return 1;
+  }
+
+  milia::thread_pool pool(opt.threads);
+  opt.threads = pool.size();
+  const std::vector<double> z = redshifts(opt.size);
+  std::vector<double> res(z.size());
+
+  report rep(opt);
+  for (std::size_t i = 0; i < NCOSMO; ++i)
+  {
+    bench_flrw_nat(rep, opt, pool, COSMOLOGIES[i], z, res);
+    bench_rei(rep, opt, COSMOLOGIES[i], z);
+    bench_quadrature(rep, opt, COSMOLOGIES[i], z, res);
+  }
+  return 0;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Cost and accuracy map of milia::flrw_nat
+ *
+ * Sweeps a grid of matter and vacuum densities and a list of
+ * redshifts. For each cell it writes, as a CSV row:
+ *   matter, vacuum, z
+ *   case      computation case, from milia/stats.h, none if the
+ *             densities have no case and - if they are not accepted
+ *   branch    paths taken by the age (milia::stats::path), - if none
+ *   flags     no_bigbang and recollapse, as check_bigbang and
+ *             check_recollapse, - if none
+ *   dl_ns, age_ns
+ *             time per call of the scalar dl and age
+ *   dl_error, age_error
+ *             relative errors with respect to the numerical
+ *             integration of 1 / E(z) with a tight tolerance
+ *   status    ok, no computation case or the message of the exception
+ * The rows of one density pair have the same matter and vacuum, so the
+ * map can be plotted per redshift with any tool that reads CSV.
+ *
+ * Usage: milia_map [--matter min max n] [--vacuum min max n]
+ *                  [--z z1,z2,...] [--reps n]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "milia/flrw_nat.h"
+#include "milia/metric.h"
+#include "milia/quadrature.h"
+#include "milia/stats.h"
+#include "milia/util.h"
+
+namespace
+{
+  // Tolerance of the reference integrals
+  const double REF_TOL = 1e-14;
+
+  struct range
+  {
+      double min;
+      double max;
+      int n;
+
+      double at(int i) const
+      {
+        return n > 1 ? min + (max - min) * i / (n - 1) : min;
+      }
+  };
+
+  struct options
+  {
+      range matter;
+      range vacuum;
+      std::vector<double> z;
+      int reps;
+  };
+
+  double now()
+  {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+  }
+
+  // 1 / E(z)
+  struct distance_integrand
+  {
+      double om;
+      double ov;
+
+      double operator()(double z) const
+      {
+        const double zp = 1 + z;
+        return 1. / std::sqrt(zp * zp * (1 + om * z) - z * ov * (2 + z));
+      }
+  };
+
+  // Luminosity distance from the integral of the comoving distance
+  double reference_dl(double om, double ov, double z)
+  {
+    const distance_integrand f = { om, ov };
+    const double dc = milia::quadrature::interval(f, 0, z, REF_TOL);
+    const double ok = 1 - om - ov;
+    const int kap = ok > 0 ? -1 : (ok < 0 ? 1 : 0);
+    return (1 + z) * milia::sinc(kap, std::sqrt(std::abs(ok)), dc);
+  }
+
+  double reference_age(double om, double ov, double z)
+  {
+    const milia::age_integrand f = { om, ov };
+    return milia::quadrature::upper(f, z, REF_TOL);
+  }
+
+  double relative_error(double value, double ref)
+  {
+    return std::abs(value - ref) / std::abs(ref);
+  }
+
+  // Time per call of a scalar method, the smallest of three runs
+  double time_call(const milia::flrw_nat& m, double
+  (milia::flrw_nat::*method)(double) const, double z, int reps)
+  {
+    double best = std::numeric_limits<double>::infinity();
+    volatile double sink = 0;
+    for (int r = 0; r < 3; ++r)
+    {
+      const double t0 = now();
+      for (int i = 0; i < reps; ++i)
+        sink = sink + (m.*method)(z);
+      best = std::min(best, (now() - t0) * 1e9 / reps);
+    }
+    return best;
+  }
+
+  // Case and paths of one evaluation of the age, from the counters
+  void branch(const milia::flrw_nat& m, double z, std::string& case_name,
+      std::string& paths)
+  {
+    milia::stats::enable(true);
+    milia::stats::reset();
+    try
+    {
+      m.age(z);
+    }
+    catch (const std::exception&)
+    {
+    }
+    milia::stats::enable(false);
+    const milia::stats::counters c = milia::stats::snapshot();
+    // densities accepted by the constructor without a case
+    case_name = "none";
+    for (std::size_t k = 0; k < milia::stats::NCASES; ++k)
+      if (c.calls[k][milia::stats::KERNEL_AGE])
+        case_name = milia::stats::case_name(k);
+    paths.clear();
+    for (int p = 0; p < milia::stats::NPATHS; ++p)
+      if (c.paths[p])
+      {
+        if (!paths.empty())
+          paths += '+';
+        paths += milia::stats::path_name(milia::stats::path(p));
+      }
+    if (paths.empty())
+      paths = "-";
+  }
+
+  std::string flags(double om, double ov)
+  {
+    std::string f;
+    if (!milia::check_bigbang(om, ov))
+      f = "no_bigbang";
+    if (milia::check_recollapse(om, ov))
+      f += f.empty() ? "recollapse" : "+recollapse";
+    return f.empty() ? "-" : f;
+  }
+
+  // The messages of the exceptions, without quotes
+  std::string quote(const std::string& s)
+  {
+    std::string r(s);
+    std::replace(r.begin(), r.end(), '"', '\'');
+    return '"' + r + '"';
+  }
+
+  void cell(const options& opt, double om, double ov, double z)
+  {
+    const std::string fl = flags(om, ov);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double dl_ns = nan, age_ns = nan, dl_err = nan, age_err = nan;
+    std::string case_name, paths = "-", status = "ok";
+    try
+    {
+      const milia::flrw_nat m(om, ov);
+      branch(m, z, case_name, paths);
+      // the methods return -1, as the GRID_ERROR cells of milia::grid
+      if (case_name == "none")
+        throw std::domain_error("no computation case");
+      const double dl = m.dl(z);
+      dl_ns = time_call(m, &milia::flrw_nat::dl, z, opt.reps);
+      try
+      {
+        dl_err = relative_error(dl, reference_dl(om, ov, z));
+      }
+      catch (const std::exception&)
+      {
+      }
+      const double age = m.age(z);
+      age_ns = time_call(m, &milia::flrw_nat::age, z, opt.reps);
+      try
+      {
+        age_err = relative_error(age, reference_age(om, ov, z));
+      }
+      catch (const std::exception&)
+      {
+      }
+    }
+    catch (const std::exception& e)
+    {
+      status = e.what();
+    }
+    std::printf("%g,%g,%g,%s,%s,%s,%.4g,%.4g,%.3g,%.3g,%s\n", om, ov, z,
+        case_name.empty() ? "-" : case_name.c_str(), paths.c_str(),
+        fl.c_str(), dl_ns, age_ns, dl_err, age_err, quote(status).c_str());
+  }
+
+  bool parse_range(int argc, char** argv, int& i, range& r)
+  {
+    if (i + 3 >= argc)
+      return false;
+    r.min = std::atof(argv[++i]);
+    r.max = std::atof(argv[++i]);
+    r.n = std::atoi(argv[++i]);
+    return r.n > 0;
+  }
+
+  bool parse(int argc, char** argv, options& opt)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const char* arg = argv[i];
+      if (std::strcmp(arg, "--matter") == 0)
+      {
+        if (!parse_range(argc, argv, i, opt.matter))
+          return false;
+      }
+      else if (std::strcmp(arg, "--vacuum") == 0)
+      {
+        if (!parse_range(argc, argv, i, opt.vacuum))
+          return false;
+      }
+      else if (i + 1 < argc && std::strcmp(arg, "--z") == 0)
+      {
+        opt.z.clear();
+        char* p = argv[++i];
+        while (*p)
+        {
+          char* end;
+          opt.z.push_back(std::strtod(p, &end));
+          if (end == p)
+            return false;
+          p = *end == ',' ? end + 1 : end;
+        }
+      }
+      else if (i + 1 < argc && std::strcmp(arg, "--reps") == 0)
+        opt.reps = std::atoi(argv[++i]);
+      else
+        return false;
+    }
+    return !opt.z.empty() && opt.reps > 0;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const range matter = { 0, 2.5, 26 };
+  const range vacuum = { 0, 2.5, 26 };
+  const double z[] = { 0.1, 0.5, 1, 3, 10 };
+  options opt = { matter, vacuum, std::vector<double>(z, z + 5), 100 };
+  if (!parse(argc, argv, opt))
+  {
+    std::fprintf(stderr, "Usage: %s [--matter min max n] [--vacuum min max n]"
+      " [--z z1,z2,...] [--reps n]\n", argv[0]);
+    return 1;
+  }
+
+  std::printf("matter,vacuum,z,case,branch,flags,dl_ns,age_ns,dl_error,"
+    "age_error,status\n");
+  for (int i = 0; i < opt.matter.n; ++i)
+    for (int j = 0; j < opt.vacuum.n; ++j)
+      for (std::size_t k = 0; k < opt.z.size(); ++k)
+        cell(opt, opt.matter.at(i), opt.vacuum.at(j), opt.z[k]);
+  return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "accuracy.h"
+
+#include "ellint.h"
+#include "flrw_prec.h"
+
+namespace milia
+{
+    tolerances get_tolerances(accuracy acc)
+    {
+      tolerances tol;
+      switch (acc)
+      {
+        case ACCURACY_FAST:
+          tol.ellint = FLRW_FAST_ELLINT;
+          tol.vol_series = FLRW_FAST_VOL_SERIES;
+          tol.inverse = FLRW_FAST_TOL;
+          break;
+        case ACCURACY_STANDARD:
+          tol.ellint = FLRW_STANDARD_ELLINT;
+          tol.vol_series = FLRW_STANDARD_VOL_SERIES;
+          tol.inverse = FLRW_STANDARD_TOL;
+          break;
+        default:
+          tol.ellint = ELLINT_FULL;
+          tol.vol_series = FLRW_VOL_SERIES;
+          tol.inverse = FLRW_INV_TOL;
+          break;
+      }
+      return tol;
+    }
+
+} // namespace milia
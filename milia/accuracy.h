@@ -0,0 +1,73 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_ACCURACY_H
+#define MILIA_ACCURACY_H
+
+namespace milia
+{
+    /**
+     * Accuracy policies of the metrics.
+     *
+     * ACCURACY_REFERENCE computes to full double precision and is the
+     * default. ACCURACY_STANDARD aims at a relative error of 1e-10 and
+     * ACCURACY_FAST at 1e-6: the duplication of the elliptic integrals
+     * and Newton's method of the inverses stop earlier, and the series
+     * at low z are used over a wider range.
+     * The closed forms do not depend on the policy.
+     *
+     * The bounds hold for matter densities down to 0.1 with
+     * ACCURACY_STANDARD and 0.001 with ACCURACY_FAST. In open models
+     * with less matter the distances at low z are differences of close
+     * elliptic integrals. With ACCURACY_STANDARD the error reaches 1e-8
+     * in the volume at matter 0.01 and z = 0.001. With even less matter,
+     * all the policies lose digits, ACCURACY_REFERENCE included.
+     */
+    enum accuracy
+    {
+      ACCURACY_FAST, //!< relative error 1e-6
+      ACCURACY_STANDARD, //!< relative error 1e-10
+      ACCURACY_REFERENCE //!< full precision
+    };
+
+    /**
+     * Tolerances of an accuracy policy
+     */
+    struct tolerances
+    {
+        //! relative tolerance of the elliptic integrals
+        double ellint;
+        //! the comoving volume uses its series when |ok dm^2| is below this
+        double vol_series;
+        //! relative tolerance in log(1 + z) of the inverse functions
+        double inverse;
+    };
+
+    /**
+     * Tolerances of an accuracy policy
+     *
+     * @param acc accuracy policy
+     * @return the tolerances
+     */
+    tolerances get_tolerances(accuracy acc);
+
+} // namespace milia
+
+#endif /* MILIA_ACCURACY_H */
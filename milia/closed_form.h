@@ -0,0 +1,191 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_CLOSED_FORM_H
+#define MILIA_CLOSED_FORM_H
+
+#include <cmath>
+
+/*
+ * The functions are constexpr when the compiler evaluates the
+ * functions of <cmath> in constant expressions (GCC in C++11 and
+ * later, as an extension). Otherwise they are inline, and calls with
+ * constant arguments are folded by the optimizer.
+ */
+#if __cplusplus >= 201103L && defined(__GNUC__) && !defined(__clang__)
+#define MILIA_HAS_CONSTEXPR 1
+#define MILIA_CONSTEXPR constexpr
+#else
+#define MILIA_HAS_CONSTEXPR 0
+#define MILIA_CONSTEXPR inline
+#include <boost/math/special_functions/asinh.hpp>
+#include <boost/math/special_functions/atanh.hpp>
+#endif
+
+namespace milia
+{
+  /**
+   * Closed forms of the cosmologies without elliptic integrals
+   *
+   * Luminosity distances and ages in natural units, as pure functions
+   * of the densities and the redshift. They are the kernels of the
+   * model classes of milia/flatmodel.h and milia/nonflatmodel.h. Each
+   * is a single expression, so that it is a valid C++11 constexpr
+   * function, and is a template on the floating point type: the
+   * constants are integers, and the arithmetic is done in the type of
+   * the arguments. The luminosity distance of flat models with matter
+   * and vacuum needs an elliptic integral and is not here.
+   */
+  namespace closed_form
+  {
+    using std::sqrt;
+    using std::atan;
+    using std::log;
+#if MILIA_HAS_CONSTEXPR
+    using std::asinh;
+    using std::atanh;
+#else
+    using boost::math::asinh;
+    using boost::math::atanh;
+#endif
+
+    // The floating point types of the functions, an integer
+    // argument is an error instead of truncating the result
+    // Other types can be added with a specialization, the functions
+    // of <cmath> are found by argument-dependent lookup
+    template<class T>
+    struct scalar
+    {
+    };
+
+    template<>
+    struct scalar<float>
+    {
+        typedef float type;
+    };
+
+    template<>
+    struct scalar<double>
+    {
+        typedef double type;
+    };
+
+    template<>
+    struct scalar<long double>
+    {
+        typedef long double type;
+    };
+
+    // The distances are written without differences of nearly equal
+    // terms at low z, such as 1 + z - sqrt(1 + z), that lose digits in
+    // float
+
+    /// Luminosity distance of Einstein-de Sitter (matter 1, vacuum 0)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type eds_dl(T z)
+    {
+      return 2 * z * sqrt(1 + z) / (1 + sqrt(1 + z));
+    }
+
+    /// Age of Einstein-de Sitter
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type eds_age(T z)
+    {
+      return 2 / (3 * (1 + z) * sqrt(1 + z));
+    }
+
+    /// Luminosity distance of de Sitter (matter 0, vacuum 1)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type de_sitter_dl(T z)
+    {
+      return z * (z + 1);
+    }
+
+    /// Look-back time of de Sitter, its age is infinite
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type de_sitter_lt(T z)
+    {
+      return log(1 + z);
+    }
+
+    /// Luminosity distance of the empty Universe (matter 0, vacuum 0)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type empty_dl(T z)
+    {
+      return z * (z + 2) / 2;
+    }
+
+    /// Age of the empty Universe
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type empty_age(T z)
+    {
+      return 1 / (1 + z);
+    }
+
+    /// Luminosity distance with matter only (matter > 0, vacuum 0)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type matter_dl(T matter, T z)
+    {
+      return 2 * z * (1 + z + sqrt(1 + matter * z)) / ((1 + sqrt(1 + matter
+          * z)) * (1 + sqrt(1 + matter * z)));
+    }
+
+    /// Age of the open Universe with matter only (0 < matter < 1)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type open_matter_age(T matter, T z)
+    {
+      return (sqrt(1 + matter * z) / (1 + z) - matter / sqrt(1 - matter)
+          * atanh(sqrt(1 - matter) / sqrt(1 + matter * z))) / (1 - matter);
+    }
+
+    /// Age of the closed Universe with matter only (matter > 1)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type closed_matter_age(T matter, T z)
+    {
+      return (sqrt(1 + matter * z) / (1 + z) - matter / sqrt(matter - 1)
+          * atan(sqrt(matter - 1) / sqrt(1 + matter * z))) / (1 - matter);
+    }
+
+    /// Luminosity distance with vacuum only (matter 0, 0 < vacuum < 1)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type vacuum_dl(T vacuum, T z)
+    {
+      return (1 + z) * z * (2 + z) / (1 + z + sqrt(vacuum + (1 - vacuum)
+          * (1 + z) * (1 + z)));
+    }
+
+    /// Age with vacuum only
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type vacuum_age(T vacuum, T z)
+    {
+      return asinh(1 / ((1 + z) * sqrt(1 / vacuum - 1))) / sqrt(vacuum);
+    }
+
+    /// Age of the flat Universe with matter and vacuum (matter + vacuum = 1)
+    template<class T>
+    MILIA_CONSTEXPR typename scalar<T>::type flat_age(T matter, T z)
+    {
+      return 2 / (3 * sqrt(1 - matter)) * asinh(sqrt((1 - matter) / matter
+          / ((1 + z) * (1 + z) * (1 + z))));
+    }
+  } // namespace closed_form
+} // namespace milia
+
+#endif /* MILIA_CLOSED_FORM_H */
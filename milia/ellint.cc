@@ -0,0 +1,398 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <boost/math/constants/constants.hpp>
+#include <boost/math/special_functions/atanh.hpp>
+
+#include "ellint.h"
+
+using std::abs;
+using std::atan;
+using std::cos;
+using std::floor;
+using std::log;
+using std::max;
+using std::min;
+using std::pow;
+using std::sin;
+using std::sqrt;
+
+using boost::math::atanh;
+
+namespace
+{
+  const double PI = boost::math::constants::pi<double>();
+
+  // Width of the blocks in the array versions
+  const std::size_t LANES = 8;
+
+  // Stopping criteria of the duplication, Carlson (1995)
+  // and DLMF 19.36.1 and 19.36.2
+  const double RF_Q = pow(3 * milia::ELLINT_FULL, -1. / 8);
+  const double RJ_Q = pow(0.25 * milia::ELLINT_FULL, -1. / 8);
+
+  // The same criteria for a relative tolerance rtol
+  // The bound of the error of RJ is 3 times that of RF
+  inline double rf_q(double rtol)
+  {
+    return rtol == milia::ELLINT_FULL ? RF_Q : 1 / sqrt(sqrt(sqrt(3 * rtol)));
+  }
+
+  inline double rj_q(double rtol)
+  {
+    return rtol == milia::ELLINT_FULL ? RJ_Q : 1 / sqrt(sqrt(sqrt(rtol / 12)));
+  }
+
+  // RF in terms of the reduced arguments once the duplication converges
+  inline double rf_series(double X, double Y, double An)
+  {
+    const double Z = -X - Y;
+    const double E2 = X * Y - Z * Z;
+    const double E3 = X * Y * Z;
+    return (1 + E3 * (1. / 14 + 3 * E3 / 104) + E2 * (-1. / 10 + E2 / 24 - 3
+        * E3 / 44 - 5 * E2 * E2 / 208 + E2 * E3 / 16)) / sqrt(An);
+  }
+
+  // RJ in terms of the reduced arguments once the duplication converges
+  inline double rj_series(double X, double Y, double Z, double fn, double An)
+  {
+    const double P = -0.5 * (X + Y + Z);
+    const double E2 = X * Y + X * Z + Y * Z - 3 * P * P;
+    const double E3 = X * Y * Z + 2 * E2 * P + 4 * P * P * P;
+    const double E4 = (2 * X * Y * Z + E2 * P + 3 * P * P * P) * P;
+    const double E5 = X * Y * Z * P * P;
+    return (1 - 3 * E2 / 14 + E3 / 6 + 9 * E2 * E2 / 88 - 3 * E4 / 22 - 9 * E2
+        * E3 / 52 + 3 * E5 / 26) / (fn * An * sqrt(An));
+  }
+
+  // RC(1, 1 + e), used in the sum of RJ
+  inline double rc1(double e)
+  {
+    if (e > 0)
+      return atan(sqrt(e)) / sqrt(e);
+    if (e < 0)
+      return atanh(sqrt(-e)) / sqrt(-e);
+    return 1;
+  }
+
+  // RF over a block of LANES elements
+  // All the lanes run the same number of duplications
+  void rf_lanes(const double* x, const double* y, const double* z,
+      double* res, double q)
+  {
+    double xn[LANES], yn[LANES], zn[LANES], An[LANES], A0[LANES], Q[LANES];
+    for (std::size_t l = 0; l < LANES; ++l)
+    {
+      xn[l] = x[l];
+      yn[l] = y[l];
+      zn[l] = z[l];
+      A0[l] = An[l] = (x[l] + y[l] + z[l]) / 3;
+      Q[l] = q * max(max(abs(A0[l] - x[l]), abs(A0[l] - y[l])), abs(A0[l]
+          - z[l]));
+    }
+    double fn = 1;
+    for (;;)
+    {
+      bool done = true;
+      for (std::size_t l = 0; l < LANES; ++l)
+        done = done && (Q[l] < fn * abs(An[l]));
+      if (done)
+        break;
+      for (std::size_t l = 0; l < LANES; ++l)
+      {
+        const double rx = sqrt(xn[l]);
+        const double ry = sqrt(yn[l]);
+        const double rz = sqrt(zn[l]);
+        const double lambda = rx * ry + rx * rz + ry * rz;
+        xn[l] = 0.25 * (xn[l] + lambda);
+        yn[l] = 0.25 * (yn[l] + lambda);
+        zn[l] = 0.25 * (zn[l] + lambda);
+        An[l] = 0.25 * (An[l] + lambda);
+      }
+      fn *= 4;
+    }
+    for (std::size_t l = 0; l < LANES; ++l)
+      res[l] = rf_series((A0[l] - x[l]) / (fn * An[l]), (A0[l] - y[l]) / (fn
+          * An[l]), An[l]);
+  }
+
+  // RJ over a block of LANES elements, p > 0 in all the lanes
+  void rj_lanes(const double* x, const double* y, const double* z,
+      const double* p, double* res, double q)
+  {
+    double xn[LANES], yn[LANES], zn[LANES], pn[LANES];
+    double An[LANES], A0[LANES], Q[LANES], delta[LANES], sum[LANES];
+    for (std::size_t l = 0; l < LANES; ++l)
+    {
+      xn[l] = x[l];
+      yn[l] = y[l];
+      zn[l] = z[l];
+      pn[l] = p[l];
+      A0[l] = An[l] = (x[l] + y[l] + z[l] + 2 * p[l]) / 5;
+      Q[l] = q * max(max(abs(A0[l] - x[l]), abs(A0[l] - y[l])), max(abs(
+          A0[l] - z[l]), abs(A0[l] - p[l])));
+      delta[l] = (p[l] - x[l]) * (p[l] - y[l]) * (p[l] - z[l]);
+      sum[l] = 0;
+    }
+    double fn = 1;
+    for (;;)
+    {
+      bool done = true;
+      for (std::size_t l = 0; l < LANES; ++l)
+        done = done && (Q[l] < fn * abs(An[l]));
+      if (done)
+        break;
+      for (std::size_t l = 0; l < LANES; ++l)
+      {
+        const double rx = sqrt(xn[l]);
+        const double ry = sqrt(yn[l]);
+        const double rz = sqrt(zn[l]);
+        const double rp = sqrt(pn[l]);
+        const double dm = (rp + rx) * (rp + ry) * (rp + rz);
+        const double em = delta[l] / (fn * fn * fn * dm * dm);
+        sum[l] += rc1(em) / (fn * dm);
+        const double lambda = rx * ry + rx * rz + ry * rz;
+        xn[l] = 0.25 * (xn[l] + lambda);
+        yn[l] = 0.25 * (yn[l] + lambda);
+        zn[l] = 0.25 * (zn[l] + lambda);
+        pn[l] = 0.25 * (pn[l] + lambda);
+        An[l] = 0.25 * (An[l] + lambda);
+      }
+      fn *= 4;
+    }
+    for (std::size_t l = 0; l < LANES; ++l)
+    {
+      const double scale = 1 / (fn * An[l]);
+      res[l] = rj_series((A0[l] - x[l]) * scale, (A0[l] - y[l]) * scale,
+          (A0[l] - z[l]) * scale, fn, An[l]) + 6 * sum[l];
+    }
+  }
+
+  // Number of half periods in phi, phi - m * pi lies in [-pi/2, pi/2]
+  inline double half_periods(double phi)
+  {
+    return floor(phi / PI + 0.5);
+  }
+}
+
+namespace milia
+{
+    double ellint_rc(double x, double y)
+    {
+      // Cauchy principal value
+      if (y < 0)
+        return sqrt(x / (x - y)) * ellint_rc(x - y, -y);
+      if (x == y)
+        return 1 / sqrt(x);
+      if (x < y)
+        return atan(sqrt((y - x) / x)) / sqrt(y - x);
+      // DLMF 19.2.19, atanh loses digits when y << x
+      return log((sqrt(x) + sqrt(x - y)) / sqrt(y)) / sqrt(x - y);
+    }
+
+    double ellint_rf(double x, double y, double z, double rtol)
+    {
+      const double A0 = (x + y + z) / 3;
+      const double Q = rf_q(rtol) * max(max(abs(A0 - x), abs(A0 - y)), abs(A0 - z));
+      double xn = x, yn = y, zn = z, An = A0, fn = 1;
+      while (Q >= fn * abs(An))
+      {
+        const double rx = sqrt(xn);
+        const double ry = sqrt(yn);
+        const double rz = sqrt(zn);
+        const double lambda = rx * ry + rx * rz + ry * rz;
+        xn = 0.25 * (xn + lambda);
+        yn = 0.25 * (yn + lambda);
+        zn = 0.25 * (zn + lambda);
+        An = 0.25 * (An + lambda);
+        fn *= 4;
+      }
+      return rf_series((A0 - x) / (fn * An), (A0 - y) / (fn * An), An);
+    }
+
+    double ellint_rj(double x, double y, double z, double p, double rtol)
+    {
+      if (p <= 0)
+      {
+        // Cauchy principal value, Carlson (1995) eq. 2.22
+        const double xt = min(min(x, y), z);
+        const double zt = max(max(x, y), z);
+        const double yt = x + y + z - xt - zt;
+        const double a = 1 / (yt - p);
+        const double b = a * (zt - yt) * (yt - xt);
+        const double pt = yt + b;
+        const double rcx = ellint_rc(xt * zt / yt, p * pt / yt);
+        return a * (b * ellint_rj(xt, yt, zt, pt, rtol) + 3 * (rcx
+            - ellint_rf(xt, yt, zt, rtol)));
+      }
+      const double A0 = (x + y + z + 2 * p) / 5;
+      const double Q = rj_q(rtol) * max(max(abs(A0 - x), abs(A0 - y)), max(abs(A0
+          - z), abs(A0 - p)));
+      const double delta = (p - x) * (p - y) * (p - z);
+      double xn = x, yn = y, zn = z, pn = p, An = A0, fn = 1, sum = 0;
+      while (Q >= fn * abs(An))
+      {
+        const double rx = sqrt(xn);
+        const double ry = sqrt(yn);
+        const double rz = sqrt(zn);
+        const double rp = sqrt(pn);
+        const double dm = (rp + rx) * (rp + ry) * (rp + rz);
+        sum += rc1(delta / (fn * fn * fn * dm * dm)) / (fn * dm);
+        const double lambda = rx * ry + rx * rz + ry * rz;
+        xn = 0.25 * (xn + lambda);
+        yn = 0.25 * (yn + lambda);
+        zn = 0.25 * (zn + lambda);
+        pn = 0.25 * (pn + lambda);
+        An = 0.25 * (An + lambda);
+        fn *= 4;
+      }
+      const double scale = 1 / (fn * An);
+      return rj_series((A0 - x) * scale, (A0 - y) * scale, (A0 - z) * scale,
+          fn, An) + 6 * sum;
+    }
+
+    double ellint_f(double k, double phi, double rtol)
+    {
+      const double m = half_periods(phi);
+      const double s = sin(phi - m * PI);
+      const double c = cos(phi - m * PI);
+      double res = s * ellint_rf(c * c, 1 - k * k * s * s, 1, rtol);
+      if (m != 0)
+        res += 2 * m * ellint_rf(0, 1 - k * k, 1, rtol);
+      return res;
+    }
+
+    double ellint_pi(double k, double n, double phi, double rtol)
+    {
+      const double m = half_periods(phi);
+      const double s = sin(phi - m * PI);
+      const double c = cos(phi - m * PI);
+      const double s2 = s * s;
+      const double d = 1 - k * k * s2;
+      double res = s * ellint_rf(c * c, d, 1, rtol) + n / 3 * s * s2
+          * ellint_rj(c * c, d, 1, 1 - n * s2, rtol);
+      if (m != 0)
+        res += 2 * m * (ellint_rf(0, 1 - k * k, 1, rtol) + n / 3 * ellint_rj(
+            0, 1 - k * k, 1, 1 - n, rtol));
+      return res;
+    }
+
+    void ellint_f(double k, const double* phi, double* res, std::size_t n,
+        double rtol)
+    {
+      const double k2 = k * k;
+      const double q = rf_q(rtol);
+      double x[LANES], y[LANES], z[LANES], s[LANES], m[LANES], r[LANES];
+      std::fill(z, z + LANES, 1.);
+      // Complete integral, only if needed
+      double kc = -1;
+      for (std::size_t i = 0; i < n; i += LANES)
+      {
+        const std::size_t w = min(LANES, n - i);
+        for (std::size_t l = 0; l < LANES; ++l)
+        {
+          // unused lanes are padded with phi = 0
+          const double p = l < w ? phi[i + l] : 0;
+          m[l] = half_periods(p);
+          s[l] = sin(p - m[l] * PI);
+          const double c = cos(p - m[l] * PI);
+          x[l] = c * c;
+          y[l] = 1 - k2 * s[l] * s[l];
+        }
+        rf_lanes(x, y, z, r, q);
+        for (std::size_t l = 0; l < w; ++l)
+        {
+          res[i + l] = s[l] * r[l];
+          if (m[l] != 0)
+          {
+            if (kc < 0)
+              kc = ellint_rf(0, 1 - k2, 1, rtol);
+            res[i + l] += 2 * m[l] * kc;
+          }
+        }
+      }
+    }
+
+    void ellint_pi(double k, double n, const double* phi, double* res,
+        std::size_t np, double rtol)
+    {
+      const double k2 = k * k;
+      const double qf = rf_q(rtol);
+      const double qj = rj_q(rtol);
+      double x[LANES], y[LANES], z[LANES], p[LANES];
+      double s[LANES], m[LANES], rf[LANES], rj[LANES];
+      std::fill(z, z + LANES, 1.);
+      // Complete integral, only if needed
+      bool have_complete = false;
+      double pc = 0;
+      for (std::size_t i = 0; i < np; i += LANES)
+      {
+        const std::size_t w = min(LANES, np - i);
+        bool pv = false;
+        for (std::size_t l = 0; l < LANES; ++l)
+        {
+          // unused lanes are padded with phi = 0
+          const double ph = l < w ? phi[i + l] : 0;
+          m[l] = half_periods(ph);
+          s[l] = sin(ph - m[l] * PI);
+          const double c = cos(ph - m[l] * PI);
+          x[l] = c * c;
+          y[l] = 1 - k2 * s[l] * s[l];
+          p[l] = 1 - n * s[l] * s[l];
+          // principal values are computed out of the block
+          if (p[l] <= 0)
+          {
+            pv = true;
+            p[l] = 1;
+          }
+        }
+        rf_lanes(x, y, z, rf, qf);
+        rj_lanes(x, y, z, p, rj, qj);
+        for (std::size_t l = 0; l < w; ++l)
+        {
+          if (pv && 1 - n * s[l] * s[l] <= 0)
+            res[i + l] = ellint_pi(k, n, phi[i + l], rtol);
+          else
+          {
+            res[i + l] = s[l] * rf[l] + n / 3 * s[l] * s[l] * s[l] * rj[l];
+            if (m[l] != 0)
+            {
+              if (!have_complete)
+              {
+                pc = ellint_rf(0, 1 - k2, 1, rtol) + n / 3 * ellint_rj(0, 1
+                    - k2, 1, 1 - n, rtol);
+                have_complete = true;
+              }
+              res[i + l] += 2 * m[l] * pc;
+            }
+          }
+        }
+      }
+    }
+
+} //namespace milia
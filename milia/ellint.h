@@ -0,0 +1,71 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_ELLINT_H
+#define MILIA_ELLINT_H
+
+#include <cstddef>
+#include <limits>
+
+namespace milia
+{
+    // Carlson's symmetric elliptic integrals, in double precision
+    // See B.C. Carlson, Numer. Algorithms 10 (1995) 13-26
+    //
+    // The duplication stops when the series of the remainder has a
+    // relative error below rtol, full precision by default; F and Pi
+    // add and subtract several of them and their error is of order
+    // rtol. The cost falls by one duplication each time rtol grows by
+    // a factor 4^8
+    const double ELLINT_FULL = std::numeric_limits<double>::epsilon();
+
+    // RC(x, y), Cauchy principal value if y < 0
+    double ellint_rc(double x, double y);
+
+    // RF(x, y, z), x, y, z >= 0, at most one of them is zero
+    double ellint_rf(double x, double y, double z, double rtol = ELLINT_FULL);
+
+    // RJ(x, y, z, p), Cauchy principal value if p < 0
+    double ellint_rj(double x, double y, double z, double p,
+        double rtol = ELLINT_FULL);
+
+    // Incomplete elliptic integral of the first kind F(phi, k)
+    // Same arguments as boost::math::ellint_1
+    double ellint_f(double k, double phi, double rtol = ELLINT_FULL);
+
+    // Incomplete elliptic integral of the third kind Pi(n; phi, k)
+    // Same arguments as boost::math::ellint_3
+    // Cauchy principal value if n sin^2(phi) > 1
+    double ellint_pi(double k, double n, double phi,
+        double rtol = ELLINT_FULL);
+
+    // Array versions, with k and n shared by all the elements
+    // The arrays are processed in blocks of fixed width, so that the
+    // duplication steps run over independent lanes and can be vectorized
+    // res may be the same array as phi
+    void ellint_f(double k, const double* phi, double* res, std::size_t n,
+        double rtol = ELLINT_FULL);
+
+    void ellint_pi(double k, double n, const double* phi, double* res,
+        std::size_t np, double rtol = ELLINT_FULL);
+
+} //namespace milia
+
+#endif /* MILIA_ELLINT_H */
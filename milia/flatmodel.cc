@@ -23,82 +23,34 @@
 #endif
 
 #include <cmath>
-#include <iostream>
-
-#include <boost/math/special_functions/ellint_1.hpp>
-#include <boost/math/special_functions/cbrt.hpp>
-#include <boost/math/special_functions/pow.hpp>
 
 #include "flatmodel.h"
-
-using boost::math::asinh;
-using boost::math::pow;
-using boost::math::ellint_1;
-using boost::math::cbrt;
-
-namespace
-{
-  const double M_SQRT3 = sqrt(3);
-  const double M_4THRT3 = sqrt(M_SQRT3);
-}
+#include "ellint.h"
+#include "vmath.h"
 
 namespace milia
 {
 
   namespace impl {
-    const char* flrw_nat_OV_EDS::model() const {
-      return "OV_EDS";
-    }
-
-    double flrw_nat_OV_EDS::dl(double z) const
-    {
-      return 2 * (1 + z - std::sqrt(1 + z));
-    }
-
-    double flrw_nat_OV_EDS::age(double z) const
-    {
-      return 2 / (3 * (1 + z) * std::sqrt(1 + z));
-    }
-
-    const char* flrw_nat_OM_DS::model() const {
-      return "OM_DS";
-    }
-
-    double flrw_nat_OM_DS::dl(double z) const
-    {
-      return z * (z + 1);
-    }
-
-    double flrw_nat_OM_DS::age(double z) const
-    {
-      return 0;
-    }
-
-    double flrw_nat_OM_DS::lt(double z) const
-    {
-      return std::log(1 + z);
-    }
-
-    const char* flrw_nat_OM_OV_1::model() const {
-      return "OM_OV_1";
-    }
-
-    double flrw_nat_OM_OV_1::age(double z) const
-    {
-      return 2. / (3. * std::sqrt(m_ov)) * asinh(std::sqrt((1 / m_om - 1) / pow<3>(1 + z)));
-    }
-
-    double flrw_nat_OM_OV_1::dl(double z) const
+    void dl(const flrw_nat_OM_OV_1& m, const double* z, double* res,
+        std::size_t n)
     {
-      const double k = sqrt(0.5 + 0.25 * M_SQRT3);
-      const double c1 = M_4THRT3;
-      const double arg0 = cbrt((1 / m_om - 1));
-      const double down = 1 + (1 + M_SQRT3) * arg0;
-      const double up = 1 + (1 - M_SQRT3) * arg0;
-      const double phi = acos((z + up) / (z + down));
-      const double phi0 = acos(up / down);
-      return (1 + z) / (c1 * sqrt(m_om) * sqrt(arg0)) * (ellint_1(k, phi0)
-           - ellint_1(k, phi));
+      // the value at z = 0 with the same kernel, so that the
+      // difference cancels at low z
+      const double ellint0 = ellint_f(m.m_k, m.phi(0));
+      // the form of phi without cancellation near matter 1, the
+      // branch to acos is not needed with the arctangent of vmath
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = 2 * vmath::atan(std::sqrt(m.m_gap / (2 * z[i] + m.m_up
+            + m.m_down)));
+      ellint_f(m.m_k, res, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = (1 + z[i]) * m.m_g * (ellint0 - res[i]);
+      // as the scalar version at low z
+      const double zs = m.series_limit();
+      for (std::size_t i = 0; i < n; ++i)
+        if (z[i] < zs)
+          res[i] = (1 + z[i]) * m.dc_series(z[i]);
     }
   } //namespace impl
 
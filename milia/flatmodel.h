@@ -21,68 +21,354 @@
 #ifndef MILIA_FLRW_NAT_FLATMODEL_H
 #define MILIA_FLRW_NAT_FLATMODEL_H
 
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include <boost/math/special_functions/cbrt.hpp>
+#include <boost/math/special_functions/ellint_1.hpp>
+
+#include "closed_form.h"
 #include "flrw_nat_impl.h"
 
 namespace milia
 {
   namespace impl {
 
-    class flrw_nat_flat: public milia::impl::flrw_nat_impl
+    // The flat models are templates on the floating point type
+    // The typedefs for double are the models of flrw_nat_model
+    template<class T>
+    class basic_flrw_nat_flat: public basic_flrw_nat_impl<T>
     {
      public:
-       flrw_nat_flat(double matter, double vacuum) :
-         flrw_nat_impl(matter, vacuum)
+       basic_flrw_nat_flat(T matter, T vacuum) :
+         basic_flrw_nat_impl<T>(matter, vacuum)
        {}
 
-        double dc(double z) const {
-          return this->dm(z);
+        T dc_from_dm(T dm) const {
+          return dm;
         }
 
-        double vol(double z) const {
-          const double lm = this->dm(z);
-          return lm * lm * lm / 3.0;
+        T vol_from_dm(T dm) const {
+          return dm * dm * dm / 3;
         }
     };
 
-    class flrw_nat_OV_EDS : public flrw_nat_flat
+    template<class T>
+    class basic_flrw_nat_OV_EDS : public basic_flrw_nat_flat<T>
     {
       public:
-        flrw_nat_OV_EDS() :
-         flrw_nat_flat(1.0, 0.0)
+        basic_flrw_nat_OV_EDS() :
+         basic_flrw_nat_flat<T>(1, 0)
         {}
 
 
-        const char* model() const;
-        double dl(double z) const;
-        double age(double z) const;
+        const char* model() const
+        {
+          return "OV_EDS";
+        }
+
+        T dl(T z) const
+        {
+          return closed_form::eds_dl(z);
+        }
+
+        T age(T z) const
+        {
+          return closed_form::eds_age(z);
+        }
     };
  
-    class flrw_nat_OM_DS : public flrw_nat_flat
+    template<class T>
+    class basic_flrw_nat_OM_DS : public basic_flrw_nat_flat<T>
     {
       public:
-        flrw_nat_OM_DS() :
-         flrw_nat_flat(0.0, 1.0)
+        basic_flrw_nat_OM_DS() :
+         basic_flrw_nat_flat<T>(0, 1)
         {}
 
-        double dl(double z) const;
-        double age(double z) const;
-        double lt(double z) const;
-        const char* model() const;
+        T dl(T z) const
+        {
+          return closed_form::de_sitter_dl(z);
+        }
+
+        T age(T) const
+        {
+          return 0;
+        }
+
+        const char* model() const
+        {
+          return "OM_DS";
+        }
     };
 
-    class flrw_nat_OM_OV_1 : public flrw_nat_flat
+    // de Sitter's Universe age is infinite
+    // but look-back time is valid
+    template<class T>
+    inline T lt_from_age(const basic_flrw_nat_OM_DS<T>&, T z, T)
+    {
+      return closed_form::de_sitter_lt(z);
+    }
+
+    template<class T>
+    class basic_flrw_nat_OM_OV_1;
+
+    typedef basic_flrw_nat_OM_OV_1<double> flrw_nat_OM_OV_1;
+
+    // Array version of dl, with the elliptic integrals of ellint.h
+    void dl(const flrw_nat_OM_OV_1& m, const double* z, double* res,
+        std::size_t n);
+
+    template<class T>
+    class basic_flrw_nat_OM_OV_1 : public basic_flrw_nat_flat<T>
     {
       public:
-        flrw_nat_OM_OV_1(double matter) :
-         flrw_nat_flat(matter, 1 - matter)
-        {}
+        basic_flrw_nat_OM_OV_1(T matter) :
+          basic_flrw_nat_flat<T>(matter, 1 - matter)
+        {
+          using std::sqrt;
+          const T sqrt3 = sqrt(T(3));
+          const T arg0 = boost::math::cbrt((1 - this->m_om) / this->m_om);
+          m_down = 1 + (1 + sqrt3) * arg0;
+          m_up = 1 + (1 - sqrt3) * arg0;
+          m_gap = 2 * sqrt3 * arg0;
+          m_g = 1 / (sqrt(sqrt3) * sqrt(this->m_om) * sqrt(arg0));
+          m_k = sqrt(T(1) / 2 + sqrt3 / 4);
+          m_ellint0 = boost::math::ellint_1(m_k, phi(0));
+        }
 
-        double dl(double z) const;
+        T dl(T z) const
+        {
+          if (z < series_limit())
+            return (1 + z) * dc_series(z);
+          return (1 + z) * m_g * (m_ellint0 - boost::math::ellint_1(m_k,
+              phi(z)));
+        }
+
+        T age(T z) const
+        {
+          return closed_form::flat_age(this->m_om, z);
+        }
 
-        double age(double z) const;
-        const char* model() const;
+        const char* model() const
+        {
+          return "OM_OV_1";
+        }
 
       private:
+        friend void dl(const flrw_nat_OM_OV_1& m, const double* z,
+            double* res, std::size_t n);
+
+        // Amplitude of the elliptic integral at z, acos(x) with
+        // x = (z + up) / (z + down). x tends to 1 at high z and when
+        // matter tends to 1, where acos loses the digits of the small
+        // angle (1e-5 in float at matter 0.9999); there it is
+        // 2 atan(sqrt((1 - x) / (1 + x))), with 1 - x = (down - up) / (z
+        // + down) exact
+        T phi(T z) const
+        {
+          using std::acos;
+          using std::atan;
+          using std::sqrt;
+          const T x = (z + m_up) / (z + m_down);
+          if (x < T(1) / 2)
+            return acos(x);
+          return 2 * atan(sqrt(m_gap / (2 * z + m_up + m_down)));
+        }
+
+        // Precision of T in bits
+        static int digits()
+        {
+          return std::numeric_limits<T>::digits;
+        }
+
+        // Below this redshift the elliptic integrals cancel, to about
+        // eps / z. In float the cancellation is larger than the
+        // accuracy wanted up to higher z
+        static T series_limit()
+        {
+          return digits() > 24 ? T(0.25) : T(0.6);
+        }
+
+        // Comoving distance at low z
+        // Taylor series of 1 / E(z), E^2 = 1 + om (3 z + 3 z^2 + z^3),
+        // with terms h_n = g_n z^n given by
+        // (1 + u) g' = - u' g / 2, u = E^2 - 1
+        // The radius of convergence is at least sqrt(3) / 2, the terms
+        // decrease by 0.29 or less at z < 0.25, 0.7 at z < 0.6. The
+        // number of terms reaches the precision of T
+        T dc_series(T z) const
+        {
+          const int nterms = digits() > 24 ? digits() * 9 / 16 + 3 : 50;
+          const T b1 = 3 * this->m_om * z;
+          const T b2 = b1 * z;
+          const T b3 = this->m_om * z * z * z;
+          T h2 = 0;
+          T h1 = 0;
+          T h0 = 1;
+          T sum = 1;
+          for (int n = 0; n < nterms; ++n)
+          {
+            const T h = -(b1 * (n + T(0.5)) * h0 + b2 * n * h1 + b3 * (n
+                - T(0.5)) * h2) / (n + 1);
+            h2 = h1;
+            h1 = h0;
+            h0 = h;
+            sum += h / (n + 2);
+          }
+          return z * sum;
+        }
+
+        // Terms that depend only on the matter density
+        // Arguments of acos
+        T m_up;
+        T m_down;
+        // down - up
+        T m_gap;
+        // Scale and modulus of the elliptic integral
+        T m_g;
+        T m_k;
+        // Elliptic integral at z = 0
+        T m_ellint0;
+    };
+
+    typedef basic_flrw_nat_flat<double> flrw_nat_flat;
+    typedef basic_flrw_nat_OV_EDS<double> flrw_nat_OV_EDS;
+    typedef basic_flrw_nat_OM_DS<double> flrw_nat_OM_DS;
+
+    // Flat model with matter and vacuum, approximate
+    //
+    // The methods of flrw_nat_OM_OV_1 without elliptic integrals, 10 to
+    // 30 times faster. The relative error of the distances is below
+    // 1e-6 for matter in [0.05, 1] and z in [0, 1100], checked in
+    // tests/FlatApproxTest.cc. The age has a closed form and is exact.
+    //
+    // With a = 1 / (1 + z), s^3 = (1 - om) / om and y = s a
+    //   dc = (G(s) - G(y)) / sqrt(om s), G(y) = int_0^y du / sqrt(u + u^4)
+    // and G(y) = 2 sqrt(y) H(y^3) if y <= 1, G(inf) - J(y^-3) / y if y > 1,
+    // with H(t) = 2F1(1/6, 1/2; 7/6; -t) and J(u) = 2F1(1/3, 1/2; 4/3; -u)
+    // in [0, 1]. H and J are polynomials of degree 7, fitted in Chebyshev
+    // nodes, with a relative error below 2e-8. The difference of G
+    // cancels at low z, where the Taylor series of dc is used
+    class flrw_nat_OM_OV_1_approx : public flrw_nat_flat
+    {
+      public:
+        explicit flrw_nat_OM_OV_1_approx(double matter) :
+          flrw_nat_flat(matter, 1 - matter)
+        {
+          m_t0 = (1 - m_om) / m_om;
+          m_s = boost::math::cbrt(m_t0);
+          m_scale = 2 / std::sqrt(m_om);
+          m_hs = fit_h(m_t0);
+          m_c = 0;
+          m_js = 0;
+          if (m_s > 1)
+          {
+            m_c = 1 / std::sqrt(m_om * m_s);
+            m_js = fit_j(1 / m_t0) / m_s;
+          }
+          // the recurrence of basic_flrw_nat_OM_OV_1::dc_series at z = 1
+          double h2 = 0;
+          double h1 = 0;
+          double h0 = 1;
+          m_series[0] = 1;
+          for (int n = 0; n + 1 < SERIES_TERMS; ++n)
+          {
+            const double h = -m_om * (3 * (n + 0.5) * h0 + 3 * n * h1 + (n
+                - 0.5) * h2) / (n + 1);
+            h2 = h1;
+            h1 = h0;
+            h0 = h;
+            m_series[n + 1] = h / (n + 2);
+          }
+        }
+
+        double dl(double z) const
+        {
+          return (1 + z) * comoving(z);
+        }
+
+        double age(double z) const
+        {
+          return closed_form::flat_age(m_om, z);
+        }
+
+        const char* model() const
+        {
+          return "OM_OV_1";
+        }
+
+      private:
+        // Terms of the series, the radius of convergence is at
+        // least sqrt(3) / 2 and the terms decrease by 0.23 or less
+        // below the limit
+        enum
+        {
+          SERIES_TERMS = 12
+        };
+
+        static double series_limit()
+        {
+          return 0.2;
+        }
+
+        // G(inf) = B(1/6, 1/3) / 3
+        static double g_inf()
+        {
+          return 2.8043642106509085;
+        }
+
+        // Fits of H and J in [0, 1]
+        static double fit_h(double t)
+        {
+          return 0.99999999184949884 + t * (-0.071427479984419548 + t
+              * (0.028821815749636007 + t * (-0.016235777905031269 + t
+              * (0.0099988513803575662 + t * (-0.0055170843649051315 + t
+              * (0.0021427172574260346 + t * -0.00040305606472157733))))));
+        }
+
+        static double fit_j(double u)
+        {
+          return 0.99999998412330449 + u * (-0.12499787363929217 + u
+              * (0.05352400410534882 + u * (-0.03083759401434185 + u
+              * (0.019203456158403413 + u * (-0.010656715512034214 + u
+              * (0.0041510070593459092 + u * -0.00078203749157551659))))));
+        }
+
+        // Comoving distance
+        double comoving(double z) const
+        {
+          if (z < series_limit())
+          {
+            double p = m_series[SERIES_TERMS - 1];
+            for (int i = SERIES_TERMS - 2; i >= 0; --i)
+              p = p * z + m_series[i];
+            return z * p;
+          }
+          const double a = 1 / (1 + z);
+          // s <= 1, dc = 2 / sqrt(om) (H(s^3) - sqrt(a) H(s^3 a^3))
+          if (m_s <= 1)
+            return m_scale * (m_hs - std::sqrt(a) * fit_h(m_t0 * a * a * a));
+          const double y = m_s * a;
+          const double y3 = y * y * y;
+          if (y <= 1)
+            return m_c * (g_inf() - m_js) - m_scale * std::sqrt(a) * fit_h(y3);
+          return m_c * (fit_j(1 / y3) / y - m_js);
+        }
+
+        // Terms that depend only on the matter density
+        // s^3 and s
+        double m_t0;
+        double m_s;
+        // 2 / sqrt(om) and H(s^3)
+        double m_scale;
+        double m_hs;
+        // 1 / sqrt(om s) and J(s^-3) / s, if s > 1
+        double m_c;
+        double m_js;
+        // Taylor coefficients of dc / z
+        double m_series[SERIES_TERMS];
     };
   } // namespace impl
 
@@ -22,6 +22,7 @@
 #include <config.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
@@ -29,14 +30,23 @@
 #include "flrw.h"
 #include "flrw_prec.h"
 
+namespace
+{
+  // Block of a column, columns not requested may be null
+  inline double* offset(double* col, std::size_t i)
+  {
+    return col ? col + i : 0;
+  }
+}
+
 namespace milia
 {
 
 
     flrw::flrw(double h, double m, double v) :
       flrw_nat(m, v),
-      ms_hubble_radius(299792.458),
-      ms_hubble_time(977.792222),
+      ms_hubble_radius(HUBBLE_RADIUS),
+      ms_hubble_time(HUBBLE_TIME),
       m_hu(h), m_r_h(ms_hubble_radius / m_hu), m_t_h(
           ms_hubble_time / m_hu)
     {
@@ -65,11 +75,206 @@ namespace milia
         throw std::domain_error("Hubble constant <= 0 not allowed");
     }
 
+    void flrw::set_parameters(double matter, double vacuum, double hubble)
+    {
+      if (!(hubble > 0))
+        throw std::domain_error("Hubble constant <= 0 not allowed");
+      flrw_nat::set_parameters(matter, vacuum);
+      m_hu = hubble;
+      m_r_h = ms_hubble_radius / m_hu;
+      m_t_h = ms_hubble_time / m_hu;
+    }
+
     double flrw::angular_scale(double z) const
     {
-      // 206264.8062 converts arcsconds to radians
-      const double arcsec_to_rad = 206264.8062;
-      return da(z) * 1e6 / arcsec_to_rad;
+      return da(z) * 1e6 / ARCSEC_PER_RAD;
+    }
+
+    void flrw::dc(const double* z, double* res, std::size_t n) const
+    {
+      flrw_nat::dc(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= m_r_h;
+    }
+
+    void flrw::dm(const double* z, double* res, std::size_t n) const
+    {
+      flrw_nat::dm(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= m_r_h;
+    }
+
+    void flrw::da(const double* z, double* res, std::size_t n) const
+    {
+      flrw_nat::da(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= m_r_h;
+    }
+
+    void flrw::dl(const double* z, double* res, std::size_t n) const
+    {
+      flrw_nat::dl(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= m_r_h;
+    }
+
+    void flrw::DM(const double* z, double* res, std::size_t n) const
+    {
+      dl(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = 5 * log10(res[i]) + 25;
+    }
+
+    void flrw::vol(const double* z, double* res, std::size_t n) const
+    {
+      const double r3 = m_r_h * m_r_h * m_r_h;
+      flrw_nat::vol(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= r3;
+    }
+
+    void flrw::age(const double* z, double* res, std::size_t n) const
+    {
+      flrw_nat::age(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= m_t_h;
+    }
+
+    void flrw::lt(const double* z, double* res, std::size_t n) const
+    {
+      flrw_nat::lt(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= m_t_h;
+    }
+
+    // The inverses of flrw_nat accept res == input
+    void flrw::z_from_dl(const double* dl, double* res, std::size_t n) const
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = dl[i] / m_r_h;
+      flrw_nat::z_from_dl(res, res, n);
+    }
+
+    void flrw::z_from_DM(const double* DM, double* res, std::size_t n) const
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = pow(10., 0.2 * (DM[i] - 25)) / m_r_h;
+      flrw_nat::z_from_dl(res, res, n);
+    }
+
+    void flrw::z_from_dc(const double* dc, double* res, std::size_t n) const
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = dc[i] / m_r_h;
+      flrw_nat::z_from_dc(res, res, n);
+    }
+
+    void flrw::z_from_dm(const double* dm, double* res, std::size_t n) const
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = dm[i] / m_r_h;
+      flrw_nat::z_from_dm(res, res, n);
+    }
+
+    void flrw::z_from_vol(const double* vol, double* res, std::size_t n) const
+    {
+      const double r3 = m_r_h * m_r_h * m_r_h;
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = vol[i] / r3;
+      flrw_nat::z_from_vol(res, res, n);
+    }
+
+    void flrw::z_from_age(const double* age, double* res, std::size_t n) const
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = age[i] / m_t_h;
+      flrw_nat::z_from_age(res, res, n);
+    }
+
+    void flrw::z_from_lt(const double* lt, double* res, std::size_t n) const
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = lt[i] / m_t_h;
+      flrw_nat::z_from_lt(res, res, n);
+    }
+
+    void flrw::eval(double z, unsigned mask, quantity_values& res) const
+    {
+      unsigned nat = mask;
+      if (mask & Q_MODULUS)
+        nat |= Q_DL;
+      if (mask & Q_ANGULAR_SCALE)
+        nat |= Q_DA;
+      flrw_nat::eval(z, nat, res);
+      const double r3 = m_r_h * m_r_h * m_r_h;
+      if (nat & Q_DL)
+        res.dl *= m_r_h;
+      if (nat & Q_DA)
+        res.da *= m_r_h;
+      if (mask & Q_DM)
+        res.dm *= m_r_h;
+      if (mask & Q_DC)
+        res.dc *= m_r_h;
+      if (mask & Q_VOL)
+        res.vol *= r3;
+      if (mask & Q_AGE)
+        res.age *= m_t_h;
+      if (mask & Q_LT)
+        res.lt *= m_t_h;
+      if (mask & Q_MODULUS)
+        res.modulus = 5 * log10(res.dl) + 25;
+      if (mask & Q_ANGULAR_SCALE)
+        res.angular_scale = res.da * 1e6 / ARCSEC_PER_RAD;
+    }
+
+    void flrw::eval(const double* z, std::size_t n, unsigned mask,
+        const quantity_columns& res) const
+    {
+      const double r3 = m_r_h * m_r_h * m_r_h;
+      // dl and da are needed by the modulus and the angular scale
+      // even if they are not requested
+      double l[FLRW_BLOCK], a[FLRW_BLOCK];
+      unsigned nat = mask;
+      if (mask & Q_MODULUS)
+        nat |= Q_DL;
+      if (mask & Q_ANGULAR_SCALE)
+        nat |= Q_DA;
+      for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+      {
+        const std::size_t w = std::min(FLRW_BLOCK, n - i);
+        quantity_columns cols = quantity_columns();
+        cols.dl = (mask & Q_DL) ? res.dl + i : l;
+        cols.da = (mask & Q_DA) ? res.da + i : a;
+        cols.dm = offset(res.dm, i);
+        cols.dc = offset(res.dc, i);
+        cols.vol = offset(res.vol, i);
+        cols.age = offset(res.age, i);
+        cols.lt = offset(res.lt, i);
+        flrw_nat::eval(z + i, w, nat, cols);
+        for (std::size_t j = 0; j < w; ++j)
+        {
+          if (nat & Q_DL)
+            cols.dl[j] *= m_r_h;
+          if (nat & Q_DA)
+            cols.da[j] *= m_r_h;
+          if (mask & Q_DM)
+            cols.dm[j] *= m_r_h;
+          if (mask & Q_DC)
+            cols.dc[j] *= m_r_h;
+          if (mask & Q_VOL)
+            cols.vol[j] *= r3;
+          if (mask & Q_AGE)
+            cols.age[j] *= m_t_h;
+          if (mask & Q_LT)
+            cols.lt[j] *= m_t_h;
+        }
+        if (mask & Q_MODULUS)
+          for (std::size_t j = 0; j < w; ++j)
+            res.modulus[i + j] = 5 * log10(cols.dl[j]) + 25;
+        if (mask & Q_ANGULAR_SCALE)
+          for (std::size_t j = 0; j < w; ++j)
+            res.angular_scale[i + j] = cols.da[j] * 1e6 / ARCSEC_PER_RAD;
+      }
     }
 
 } //namespace milia
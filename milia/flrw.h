@@ -26,6 +26,7 @@
 #include <string>
 #include <ostream>
 #include <cmath>
+#include <cstddef>
 
 namespace milia
 {
@@ -42,6 +43,9 @@ namespace milia
      * Distances are computed from the luminosity distance using
      * <a href="http://xxx.unizar.es/abs/astro-ph/0002334">%astro-ph/0002334</a>
      * without inhomogeneities.
+     *
+     * Thread safety: as in milia::flrw_nat, the const methods can be
+     * called concurrently on the same object.
      */
     class flrw : public flrw_nat
     {
@@ -77,6 +81,23 @@ namespace milia
          */
         void set_hubble(double hubble);
 
+        /**
+         * Set the values of the matter density, of the vacuum energy
+         * density and of the Hubble parameter
+         *
+         * The parameters are checked and the terms that depend on them
+         * are computed once. If the parameters are not valid, the object
+         * is not modified.
+         *
+         * @param matter matter density
+         * @param vacuum vacuum energy density
+         * @param hubble Hubble parameter in \f$ km\ s^{-1}\ Mpc^{-1} \f$
+         * @throws std::domain_error if the parameters are not valid
+         */
+        void set_parameters(double matter, double vacuum, double hubble);
+
+        using flrw_nat::set_parameters;
+
         /**
          * Get the value of the Hubble parameter in \f$ km\ s^{-1}\ Mpc^{-1} \f$.
          */
@@ -170,6 +191,235 @@ namespace milia
          */
         double lt(double z) const;
 
+        /**
+         * Comoving distance (line of sight) in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dc(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Comoving distance (transverse) in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dm(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Angular distance in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void da(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Luminosity distance in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dl(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Distance modulus in mag for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the moduli are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void DM(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Comoving volume per solid angle in \f$ Mpc^3\f$ for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the volumes are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void vol(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Age of the Universe in Gyr for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the ages are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void age(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Look-back time in Gyr for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the times are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void lt(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Computes several quantities with a single evaluation of the
+         * luminosity distance and of the age. Units are those of the
+         * individual methods.
+         *
+         * @param z redshift
+         * @param mask quantities to compute, a combination of milia::quantity
+         * @param res where the requested quantities are stored
+         */
+        void eval(double z, unsigned mask, quantity_values& res) const;
+
+        /**
+         * Computes several quantities for an array of redshifts with a single
+         * evaluation of the luminosity distance and of the age per redshift.
+         *
+         * @param z array of redshifts
+         * @param n number of elements in z and in the output arrays
+         * @param mask quantities to compute, a combination of milia::quantity
+         * @param res arrays where the requested quantities are stored,
+         * they must not overlap z or each other
+         */
+        void eval(const double* z, std::size_t n, unsigned mask,
+            const quantity_columns& res) const;
+
+        /**
+         * Redshift at a given luminosity distance
+         *
+         * @param dl luminosity distance in Mpc
+         * @return redshift
+         * @throws std::domain_error if no redshift has this distance
+         */
+        double z_from_dl(double dl) const;
+
+        /**
+         * Redshift at a given distance modulus
+         *
+         * @param DM distance modulus in mag
+         * @return redshift
+         * @throws std::domain_error if no redshift has this modulus
+         */
+        double z_from_DM(double DM) const;
+
+        /**
+         * Redshift at a given comoving distance (line of sight)
+         *
+         * @param dc line of sight comoving distance in Mpc
+         * @return redshift
+         * @throws std::domain_error if no redshift has this distance
+         */
+        double z_from_dc(double dc) const;
+
+        /**
+         * Redshift at a given comoving distance (transverse)
+         *
+         * @param dm transverse comoving distance in Mpc
+         * @return redshift
+         * @throws std::domain_error if no redshift has this distance
+         */
+        double z_from_dm(double dm) const;
+
+        /**
+         * Redshift at a given comoving volume per solid angle
+         *
+         * @param vol comoving volume in \f$ Mpc^3\f$ per solid angle
+         * @return redshift
+         * @throws std::domain_error if no redshift has this volume
+         */
+        double z_from_vol(double vol) const;
+
+        /**
+         * Redshift at a given age of the Universe
+         *
+         * @param age age of the Universe in Gyr
+         * @return redshift
+         * @throws std::domain_error if no redshift has this age
+         */
+        double z_from_age(double age) const;
+
+        /**
+         * Redshift at a given look-back time
+         *
+         * @param lt look-back time in Gyr
+         * @return redshift
+         * @throws std::domain_error if no redshift has this look-back time
+         */
+        double z_from_lt(double lt) const;
+
+        /**
+         * Redshifts at an array of luminosity distances in Mpc
+         *
+         * @param dl array of luminosity distances
+         * @param res array where the redshifts are stored, must not overlap dl
+         * @param n number of elements in dl and res
+         * @throws std::domain_error if no redshift has one of the distances
+         */
+        void z_from_dl(const double* dl, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of distance moduli in mag
+         *
+         * @param DM array of distance moduli
+         * @param res array where the redshifts are stored, must not overlap DM
+         * @param n number of elements in DM and res
+         * @throws std::domain_error if no redshift has one of the moduli
+         */
+        void z_from_DM(const double* DM, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of comoving distances (line of sight) in Mpc
+         *
+         * @param dc array of line of sight comoving distances
+         * @param res array where the redshifts are stored, must not overlap dc
+         * @param n number of elements in dc and res
+         * @throws std::domain_error if no redshift has one of the distances
+         */
+        void z_from_dc(const double* dc, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of comoving distances (transverse) in Mpc
+         *
+         * @param dm array of transverse comoving distances
+         * @param res array where the redshifts are stored, must not overlap dm
+         * @param n number of elements in dm and res
+         * @throws std::domain_error if no redshift has one of the distances
+         */
+        void z_from_dm(const double* dm, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of comoving volumes in \f$ Mpc^3\f$ per solid angle
+         *
+         * @param vol array of comoving volumes per solid angle
+         * @param res array where the redshifts are stored, must not overlap vol
+         * @param n number of elements in vol and res
+         * @throws std::domain_error if no redshift has one of the volumes
+         */
+        void z_from_vol(const double* vol, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of ages of the Universe in Gyr
+         *
+         * @param age array of ages of the Universe
+         * @param res array where the redshifts are stored, must not overlap age
+         * @param n number of elements in age and res
+         * @throws std::domain_error if no redshift has one of the ages
+         */
+        void z_from_age(const double* age, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of look-back times in Gyr
+         *
+         * @param lt array of look-back times
+         * @param res array where the redshifts are stored, must not overlap lt
+         * @param n number of elements in lt and res
+         * @throws std::domain_error if no redshift has one of the times
+         */
+        void z_from_lt(const double* lt, double* res, std::size_t n) const;
+
         /**
          * String with caracteristics of the FLRW universe (Hubble parameter,
          * Matter density, vacuum energy density.
@@ -256,16 +506,56 @@ namespace milia
       return m_t_h * flrw_nat::age(z);
     }
 
+    inline double flrw::z_from_dl(double dl) const
+    {
+      return flrw_nat::z_from_dl(dl / m_r_h);
+    }
+
+    inline double flrw::z_from_DM(double DM) const
+    {
+      return z_from_dl(std::pow(10., 0.2 * (DM - 25)));
+    }
+
+    inline double flrw::z_from_dc(double dc) const
+    {
+      return flrw_nat::z_from_dc(dc / m_r_h);
+    }
+
+    inline double flrw::z_from_dm(double dm) const
+    {
+      return flrw_nat::z_from_dm(dm / m_r_h);
+    }
+
+    inline double flrw::z_from_vol(double vol) const
+    {
+      return flrw_nat::z_from_vol(vol / (m_r_h * m_r_h * m_r_h));
+    }
+
+    inline double flrw::z_from_age(double age) const
+    {
+      return flrw_nat::z_from_age(age / m_t_h);
+    }
+
+    inline double flrw::z_from_lt(double lt) const
+    {
+      return flrw_nat::z_from_lt(lt / m_t_h);
+    }
+
 } // namespace milia
 
 std::ostream& operator<<(std::ostream& os, milia::flrw& iflrw);
 
-#include <milia/flrw_nat_impl.h>
+#include <milia/flrw_nat_model.h>
 
 
 namespace milia
 {
  namespace rei {
+    // Variant of milia::flrw_nat with one class per computation case
+    // The model is held by value, without allocations, and the
+    // methods switch on its case. Objects can be copied and stored
+    // in containers.
+    // The const methods can be called concurrently on the same object
     class flrw_nat
     {
       public:
@@ -283,61 +573,83 @@ namespace milia
         double vol(double z) const;
         double age(double z) const;
         double lt(double z) const;
+        void eval(double z, unsigned mask, quantity_values& res) const;
     const char* model() const
     {
-      return m_impl->model();
+      return m_model.visit(impl::model_visitor());
     }
       private:
-        std::auto_ptr<impl::flrw_nat_impl> m_impl;
+        impl::flrw_nat_model m_model;
     };
 
     inline double flrw_nat::get_matter() const
     {
-      return m_impl->get_matter();
+      return m_model.visit(impl::parameters_visitor()).get_matter();
     }
 
     inline double flrw_nat::get_vacuum() const
     {
-      return m_impl->get_vacuum();
+      return m_model.visit(impl::parameters_visitor()).get_vacuum();
     }
 
     inline double flrw_nat::dc(double z) const
     {
-      return m_impl->dc(z);
+      const impl::dc_visitor v = { z };
+      return m_model.visit(v);
     }
 
     inline double flrw_nat::dl(double z) const
     {
-      return m_impl->dl(z);
+      const impl::dl_visitor v = { z };
+      return m_model.visit(v);
     }
 
     inline double flrw_nat::dm(double z) const
     {
-      return m_impl->dm(z);
+      const impl::dm_visitor v = { z };
+      return m_model.visit(v);
     }
 
     inline double flrw_nat::da(double z) const
     {
-      return m_impl->da(z);
+      const impl::da_visitor v = { z };
+      return m_model.visit(v);
     }
 
     inline double flrw_nat::vol(double z) const
     {
-      return m_impl->vol(z);
+      const impl::vol_visitor v = { z };
+      return m_model.visit(v);
     }
 
     inline double flrw_nat::age(double z) const
     {
-      return m_impl->age(z);
+      const impl::age_visitor v = { z };
+      return m_model.visit(v);
     }
 
+    inline double flrw_nat::lt(double z) const
+    {
+      const impl::lt_visitor v = { z };
+      return m_model.visit(v);
+    }
 
+    inline void flrw_nat::eval(double z, unsigned mask,
+        quantity_values& res) const
+    {
+      const impl::eval_visitor v = { z, mask, &res };
+      m_model.visit(v);
+    }
+
+
+    // Variant of milia::flrw, in physical units
+    // The const methods can be called concurrently on the same object
     class flrw
     {
       public:
         flrw(double hubble, double matter, double vacuum) :
-          ms_hubble_radius(299792.458),
-          ms_hubble_time(977.792222),
+          ms_hubble_radius(HUBBLE_RADIUS),
+          ms_hubble_time(HUBBLE_TIME),
           m_nat(matter, vacuum),
           m_hu(hubble),
           m_r_h(ms_hubble_radius / m_hu),
@@ -376,14 +688,43 @@ namespace milia
       {
         return m_t_h * m_nat.age(z);
       }
+
+      void eval(double z, unsigned mask, quantity_values& res) const
+      {
+        // modulus and angular scale come from dl and da
+        unsigned nat = mask;
+        if (mask & Q_MODULUS)
+          nat |= Q_DL;
+        if (mask & Q_ANGULAR_SCALE)
+          nat |= Q_DA;
+        m_nat.eval(z, nat, res);
+        if (nat & Q_DL)
+          res.dl *= m_r_h;
+        if (nat & Q_DA)
+          res.da *= m_r_h;
+        if (mask & Q_DM)
+          res.dm *= m_r_h;
+        if (mask & Q_DC)
+          res.dc *= m_r_h;
+        if (mask & Q_VOL)
+          res.vol *= m_r_h * m_r_h * m_r_h;
+        if (mask & Q_AGE)
+          res.age *= m_t_h;
+        if (mask & Q_LT)
+          res.lt *= m_t_h;
+        if (mask & Q_MODULUS)
+          res.modulus = 5 * std::log10(res.dl) + 25;
+        if (mask & Q_ANGULAR_SCALE)
+          res.angular_scale = res.da * 1e6 / ARCSEC_PER_RAD;
+      }
     const char* model() const
     {
       return m_nat.model();
     }
       private:
+        double ms_hubble_radius;
+        double ms_hubble_time;
         flrw_nat m_nat;
-        const double ms_hubble_radius;
-        const double ms_hubble_time;
         double m_hu;
         double m_r_h;
         double m_t_h;
@@ -0,0 +1,339 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include "flrw_ensemble.h"
+
+#include "ellint.h"
+#include "vmath.h"
+
+namespace
+{
+  const unsigned Q_DISTANCES = milia::Q_DL | milia::Q_DA | milia::Q_DM
+      | milia::Q_DC | milia::Q_VOL;
+  const unsigned Q_TIMES = milia::Q_AGE | milia::Q_LT;
+
+  // Row u of a column, columns not requested may be null
+  inline double* row(double* col, std::size_t u, std::size_t nz)
+  {
+    return col ? col + u * nz : 0;
+  }
+
+  // Orders the models by case, the flat ones first
+  struct case_order
+  {
+      explicit case_order(const std::vector<int>& rank) :
+        m_rank(rank)
+      {
+      }
+
+      bool operator()(std::size_t a, std::size_t b) const
+      {
+        return m_rank[a] < m_rank[b];
+      }
+
+      const std::vector<int>& m_rank;
+  };
+}
+
+namespace milia
+{
+    flrw_ensemble::flrw_ensemble(const double* hubble, const double* matter,
+        const double* vacuum, std::size_t n) :
+      m_hubble(hubble, hubble + n), m_r_h(n), m_t_h(n), m_model(n),
+          m_nflat(0), m_k(0)
+    {
+      // One natural-unit model for each pair of densities
+      typedef std::map<std::pair<double, double>, std::size_t> model_map;
+      model_map index;
+      std::vector<flrw_nat> models;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        if (hubble[i] <= 0)
+          throw std::domain_error("Hubble constant <= 0 not allowed");
+        m_r_h[i] = HUBBLE_RADIUS / hubble[i];
+        m_t_h[i] = HUBBLE_TIME / hubble[i];
+
+        const std::pair<double, double> key(matter[i], vacuum[i]);
+        model_map::iterator it = index.find(key);
+        if (it == index.end())
+        {
+          it = index.insert(std::make_pair(key, models.size())).first;
+          models.push_back(flrw_nat(matter[i], vacuum[i]));
+        }
+        m_model[i] = it->second;
+      }
+
+      // Group the models by case
+      std::vector<int> rank(models.size());
+      std::vector<std::size_t> order(models.size());
+      for (std::size_t u = 0; u < models.size(); ++u)
+      {
+        rank[u] = models[u].m_case == flrw_nat::OM_OV_1 ? -1
+            : models[u].m_case;
+        order[u] = u;
+      }
+      std::stable_sort(order.begin(), order.end(), case_order(rank));
+      std::vector<std::size_t> position(models.size());
+      m_nat.reserve(models.size());
+      for (std::size_t u = 0; u < order.size(); ++u)
+      {
+        position[order[u]] = u;
+        m_nat.push_back(models[order[u]]);
+      }
+      for (std::size_t i = 0; i < n; ++i)
+        m_model[i] = position[m_model[i]];
+
+      while (m_nflat < m_nat.size() && m_nat[m_nflat].m_case
+          == flrw_nat::OM_OV_1)
+        ++m_nflat;
+
+      // Structure of arrays of the flat models
+      m_up.resize(m_nflat);
+      m_down.resize(m_nflat);
+      m_g.resize(m_nflat);
+      m_ellint0.resize(m_nflat);
+      m_tpre.resize(m_nflat);
+      m_targ.resize(m_nflat);
+      m_uage.resize(m_nflat);
+      for (std::size_t u = 0; u < m_nflat; ++u)
+      {
+        const flrw_nat& nat = m_nat[u];
+        m_k = nat.m_k;
+        m_up[u] = nat.m_up;
+        m_down[u] = nat.m_down;
+        m_g[u] = nat.m_g;
+        // with the kernel of the array versions, as in flrw_nat::dl
+        m_ellint0[u] = ellint_f(nat.m_k, nat.m_phi0);
+        m_tpre[u] = 2. / (3. * std::sqrt(1 - nat.m_om));
+        m_targ[u] = 1. / nat.m_om - 1;
+        m_uage[u] = nat.uage();
+      }
+    }
+
+    void flrw_ensemble::eval_flat(const double* z, std::size_t nz,
+        unsigned mask, const quantity_columns& nat) const
+    {
+      const std::size_t nf = m_nflat;
+      if (nf == 0)
+        return;
+      std::vector<double> buf(2 * nf);
+      double* l = &buf[0];
+      double* t = &buf[nf];
+      const double* up = &m_up[0];
+      const double* down = &m_down[0];
+      const double* g = &m_g[0];
+      const double* ellint0 = &m_ellint0[0];
+      const double* tpre = &m_tpre[0];
+      const double* targ = &m_targ[0];
+      for (std::size_t j = 0; j < nz; ++j)
+      {
+        const double zj = z[j];
+        const double zp = 1 + zj;
+        if (mask & Q_DISTANCES)
+        {
+          for (std::size_t u = 0; u < nf; ++u)
+            l[u] = vmath::acos((zj + up[u]) / (zj + down[u]));
+          ellint_f(m_k, l, l, nf);
+          for (std::size_t u = 0; u < nf; ++u)
+            l[u] = zp * g[u] * (ellint0[u] - l[u]);
+          for (std::size_t u = 0; u < nf; ++u)
+          {
+            const double m = l[u] / zp;
+            const std::size_t k = u * nz + j;
+            if (mask & Q_DL)
+              nat.dl[k] = l[u];
+            if (mask & Q_DA)
+              nat.da[k] = m / zp;
+            if (mask & Q_DM)
+              nat.dm[k] = m;
+            if (mask & Q_DC)
+              nat.dc[k] = m;
+            if (mask & Q_VOL)
+              nat.vol[k] = m * m * m / 3.0;
+          }
+        }
+        if (mask & Q_TIMES)
+        {
+          const double zp3 = zp * zp * zp;
+          for (std::size_t u = 0; u < nf; ++u)
+            t[u] = tpre[u] * vmath::asinh(std::sqrt(targ[u] / zp3));
+          for (std::size_t u = 0; u < nf; ++u)
+          {
+            const std::size_t k = u * nz + j;
+            if (mask & Q_AGE)
+              nat.age[k] = t[u];
+            if (mask & Q_LT)
+              nat.lt[k] = m_uage[u] - t[u];
+          }
+        }
+      }
+    }
+
+    void flrw_ensemble::eval_nat(const double* z, std::size_t nz,
+        unsigned mask, const quantity_columns& nat) const
+    {
+      eval_flat(z, nz, mask, nat);
+      // The other cases are contiguous, the switch of flrw_nat
+      // takes the same branch for consecutive models
+      for (std::size_t u = m_nflat; u < m_nat.size(); ++u)
+      {
+        quantity_columns cols = quantity_columns();
+        cols.dl = row(nat.dl, u, nz);
+        cols.da = row(nat.da, u, nz);
+        cols.dm = row(nat.dm, u, nz);
+        cols.dc = row(nat.dc, u, nz);
+        cols.vol = row(nat.vol, u, nz);
+        cols.age = row(nat.age, u, nz);
+        cols.lt = row(nat.lt, u, nz);
+        m_nat[u].eval(z, nz, mask, cols);
+      }
+    }
+
+    void flrw_ensemble::eval(const double* z, std::size_t nz, unsigned mask,
+        const quantity_columns& res) const
+    {
+      // dl and da are needed by the modulus and the angular scale
+      // even if they are not requested
+      unsigned nmask = mask & (Q_DISTANCES | Q_TIMES);
+      if (mask & Q_MODULUS)
+        nmask |= Q_DL;
+      if (mask & Q_ANGULAR_SCALE)
+        nmask |= Q_DA;
+
+      // Natural-unit values, one row per model
+      const std::size_t nrow = m_nat.size() * nz;
+      std::vector<double> buf;
+      quantity_columns nat = quantity_columns();
+      double** cols[] = { &nat.dl, &nat.da, &nat.dm, &nat.dc, &nat.vol,
+          &nat.age, &nat.lt };
+      const unsigned flags[] = { Q_DL, Q_DA, Q_DM, Q_DC, Q_VOL, Q_AGE, Q_LT };
+      std::size_t ncols = 0;
+      for (std::size_t c = 0; c < 7; ++c)
+        if (nmask & flags[c])
+          ++ncols;
+      buf.resize(ncols * nrow);
+      ncols = 0;
+      for (std::size_t c = 0; c < 7; ++c)
+        if ((nmask & flags[c]) && nrow > 0)
+          *cols[c] = &buf[nrow * ncols++];
+      eval_nat(z, nz, nmask, nat);
+
+      // Physical units, one row per cosmology
+      for (std::size_t i = 0; i < size(); ++i)
+      {
+        const std::size_t src = m_model[i] * nz;
+        const std::size_t dst = i * nz;
+        const double r = m_r_h[i];
+        const double r3 = r * r * r;
+        const double th = m_t_h[i];
+        for (std::size_t j = 0; j < nz; ++j)
+        {
+          if (mask & Q_DL)
+            res.dl[dst + j] = r * nat.dl[src + j];
+          if (mask & Q_DA)
+            res.da[dst + j] = r * nat.da[src + j];
+          if (mask & Q_DM)
+            res.dm[dst + j] = r * nat.dm[src + j];
+          if (mask & Q_DC)
+            res.dc[dst + j] = r * nat.dc[src + j];
+          if (mask & Q_VOL)
+            res.vol[dst + j] = r3 * nat.vol[src + j];
+          if (mask & Q_AGE)
+            res.age[dst + j] = th * nat.age[src + j];
+          if (mask & Q_LT)
+            res.lt[dst + j] = th * nat.lt[src + j];
+        }
+        if (mask & Q_MODULUS)
+          for (std::size_t j = 0; j < nz; ++j)
+            res.modulus[dst + j] = 5 * std::log10(r * nat.dl[src + j]) + 25;
+        if (mask & Q_ANGULAR_SCALE)
+          for (std::size_t j = 0; j < nz; ++j)
+            res.angular_scale[dst + j] = r * nat.da[src + j] * 1e6
+                / ARCSEC_PER_RAD;
+      }
+    }
+
+    void flrw_ensemble::dc(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.dc = res;
+      eval(z, nz, Q_DC, cols);
+    }
+
+    void flrw_ensemble::dm(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.dm = res;
+      eval(z, nz, Q_DM, cols);
+    }
+
+    void flrw_ensemble::da(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.da = res;
+      eval(z, nz, Q_DA, cols);
+    }
+
+    void flrw_ensemble::dl(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.dl = res;
+      eval(z, nz, Q_DL, cols);
+    }
+
+    void flrw_ensemble::DM(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.modulus = res;
+      eval(z, nz, Q_MODULUS, cols);
+    }
+
+    void flrw_ensemble::vol(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.vol = res;
+      eval(z, nz, Q_VOL, cols);
+    }
+
+    void flrw_ensemble::age(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.age = res;
+      eval(z, nz, Q_AGE, cols);
+    }
+
+    void flrw_ensemble::lt(const double* z, double* res, std::size_t nz) const
+    {
+      quantity_columns cols = quantity_columns();
+      cols.lt = res;
+      eval(z, nz, Q_LT, cols);
+    }
+
+} // namespace milia
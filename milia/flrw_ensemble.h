@@ -0,0 +1,242 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_FLRW_ENSEMBLE_H
+#define MILIA_FLRW_ENSEMBLE_H
+
+#include <milia/flrw_nat.h>
+#include <milia/quantities.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace milia
+{
+    /**
+     * Many FLRW metrics evaluated at the same redshifts
+     *
+     * The cosmologies are stored as arrays of Hubble parameters,
+     * matter densities and vacuum densities. Cosmologies with the same
+     * matter and vacuum densities share one natural-unit model, the
+     * ones that differ only in the Hubble parameter are computed once
+     * and scaled.
+     *
+     * The natural-unit models are grouped by computation case. The flat
+     * models are evaluated across models, one redshift at a time, with
+     * the array kernels of the elliptic integrals (the modulus is the
+     * same for all of them). The other cases call the array versions
+     * of flrw_nat model by model, in the order of their case.
+     *
+     * The results of the array methods are stored by cosmology: the value
+     * for cosmology i at redshift z[j] is res[i * nz + j].
+     *
+     * Thread safety: the const methods can be called concurrently
+     * on the same object.
+     */
+    class flrw_ensemble
+    {
+      public:
+
+        /**
+         * Builds the ensemble
+         *
+         * @param hubble array of Hubble parameters in \f$ km\ s^{-1}\ Mpc^{-1} \f$
+         * @param matter array of matter densities
+         * @param vacuum array of vacuum energy densities
+         * @param n number of cosmologies
+         * @throws std::domain_error if one of the cosmologies is not valid
+         */
+        flrw_ensemble(const double* hubble, const double* matter,
+            const double* vacuum, std::size_t n);
+
+        /**
+         * Number of cosmologies
+         */
+        std::size_t size() const;
+
+        /**
+         * Number of different natural-unit models
+         */
+        std::size_t models() const;
+
+        /**
+         * Hubble parameter of cosmology i in \f$ km\ s^{-1}\ Mpc^{-1} \f$
+         */
+        double get_hubble(std::size_t i) const;
+
+        /**
+         * Matter density of cosmology i
+         */
+        double get_matter(std::size_t i) const;
+
+        /**
+         * Vacuum energy density of cosmology i
+         */
+        double get_vacuum(std::size_t i) const;
+
+        /**
+         * Comoving distance (line of sight) in Mpc
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the distances are stored
+         * @param nz number of redshifts
+         */
+        void dc(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Comoving distance (transverse) in Mpc
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the distances are stored
+         * @param nz number of redshifts
+         */
+        void dm(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Angular distance in Mpc
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the distances are stored
+         * @param nz number of redshifts
+         */
+        void da(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Luminosity distance in Mpc
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the distances are stored
+         * @param nz number of redshifts
+         */
+        void dl(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Distance modulus in mag
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the moduli are stored
+         * @param nz number of redshifts
+         */
+        void DM(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Comoving volume per solid angle in \f$ Mpc^3\f$
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the volumes are stored
+         * @param nz number of redshifts
+         */
+        void vol(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Age of the Universe in Gyr
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the ages are stored
+         * @param nz number of redshifts
+         */
+        void age(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Look-back time in Gyr
+         *
+         * @param z array of redshifts
+         * @param res array of size() * nz where the times are stored
+         * @param nz number of redshifts
+         */
+        void lt(const double* z, double* res, std::size_t nz) const;
+
+        /**
+         * Computes several quantities for all the cosmologies with a single
+         * evaluation of the luminosity distance and of the age per
+         * natural-unit model and redshift. Units are those of milia::flrw.
+         *
+         * @param z array of redshifts
+         * @param nz number of redshifts
+         * @param mask quantities to compute, a combination of milia::quantity
+         * @param res arrays of size() * nz where the requested quantities
+         * are stored, they must not overlap z or each other
+         */
+        void eval(const double* z, std::size_t nz, unsigned mask,
+            const quantity_columns& res) const;
+
+      private:
+        // Natural-unit quantities of all the models at the redshifts,
+        // nat.x[u * nz + j] for model u
+        void eval_nat(const double* z, std::size_t nz, unsigned mask,
+            const quantity_columns& nat) const;
+        // Flat models, across models for each redshift
+        void eval_flat(const double* z, std::size_t nz, unsigned mask,
+            const quantity_columns& nat) const;
+
+        // Cosmologies
+        std::vector<double> m_hubble;
+        // Hubble radius in Mpc and Hubble time in Gyr
+        std::vector<double> m_r_h;
+        std::vector<double> m_t_h;
+        // Natural-unit model of each cosmology
+        std::vector<std::size_t> m_model;
+
+        // Natural-unit models, sorted by computation case
+        // The first m_nflat are flat (om + ov = 1, om, ov > 0)
+        std::vector<flrw_nat> m_nat;
+        std::size_t m_nflat;
+
+        // Invariants of the flat models, see flrw_nat::compute_invariants
+        std::vector<double> m_up;
+        std::vector<double> m_down;
+        std::vector<double> m_g;
+        std::vector<double> m_ellint0;
+        // Age, 2 / (3 sqrt(ov)) asinh(sqrt(ov / om / (1 + z)^3))
+        std::vector<double> m_tpre;
+        std::vector<double> m_targ;
+        std::vector<double> m_uage;
+        // Modulus of the elliptic integrals, the same in all flat models
+        double m_k;
+    };
+
+    inline std::size_t flrw_ensemble::size() const
+    {
+      return m_hubble.size();
+    }
+
+    inline std::size_t flrw_ensemble::models() const
+    {
+      return m_nat.size();
+    }
+
+    inline double flrw_ensemble::get_hubble(std::size_t i) const
+    {
+      return m_hubble[i];
+    }
+
+    inline double flrw_ensemble::get_matter(std::size_t i) const
+    {
+      return m_nat[m_model[i]].get_matter();
+    }
+
+    inline double flrw_ensemble::get_vacuum(std::size_t i) const
+    {
+      return m_nat[m_model[i]].get_vacuum();
+    }
+
+} // namespace milia
+
+#endif /* MILIA_FLRW_ENSEMBLE_H */
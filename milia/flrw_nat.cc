@@ -22,31 +22,62 @@
 #include <config.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
 
 #include <boost/math/special_functions/asinh.hpp>
+#include <boost/math/special_functions/cbrt.hpp>
+#include <boost/math/special_functions/ellint_1.hpp>
+#include <boost/math/special_functions/ellint_3.hpp>
 #include <boost/math/special_functions/pow.hpp>
 
 #include "flrw_nat.h"
 
+#include "ellint.h"
 #include "flrw_prec.h"
 #include "metric.h"
+#include "probes.h"
+#include "stats_hooks.h"
 #include "util.h"
+#include "vmath.h"
 
 #include "flatmodel.h"
 
 using std::abs;
 using boost::math::asinh;
+using boost::math::cbrt;
 using boost::math::pow;
 
+namespace
+{
+  // Series of int_0^dm t^2 / sqrt(1 + ok t^2) dt
+  inline double vol_series(double ok, double dm)
+  {
+    const double u = ok * dm * dm;
+    // binomial coefficients of (1 + u)^(-1/2), divided by 2n + 3
+    double p = 6435. / 32768 / 19;
+    p = -429. / 2048 / 17 + u * p;
+    p = 231. / 1024 / 15 + u * p;
+    p = -63. / 256 / 13 + u * p;
+    p = 35. / 128 / 11 + u * p;
+    p = -5. / 16 / 9 + u * p;
+    p = 3. / 8 / 7 + u * p;
+    p = -1. / 2 / 5 + u * p;
+    p = 1. / 3 + u * p;
+    return dm * dm * dm * p;
+  }
+}
+
 namespace milia
 {
 
     flrw_nat::flrw_nat(double m, double v) :
-      m_om(m), m_ov(v), m_ok(1 - m_om - m_ov), m_sqok(sqrt(abs(m_ok)))
+      m_om(m), m_ov(v), m_ok(1 - m_om - m_ov), m_sqok(sqrt(abs(m_ok))),
+          m_acc(ACCURACY_REFERENCE), m_tol(get_tolerances(m_acc))
     {
+      MILIA_PROBE2(construct__entry, m, v);
 
       //om < 0 not allowed
       if (m_om < 0)
@@ -60,6 +91,7 @@ namespace milia
 
       m_kap = m_ok > 0 ? -1 : 1;
       m_case = select_case();
+      MILIA_PROBE3(select__case, m_om, m_ov, stats_case());
 
       /*
           NO_CASE, // error condition
@@ -82,7 +114,8 @@ namespace milia
 
       }
 
-      m_uage = m_case != OM_DS ? age(0) : 0;
+      compute_invariants();
+      MILIA_PROBE3(construct__return, m_om, m_ov, stats_case());
     }
 
     std::string flrw_nat::to_string() const
@@ -123,7 +156,11 @@ namespace milia
       m_crit = B;
       m_kap = (m_ok > 0 ? -1 : 1);
       m_case = select_case();
-      m_uage = m_case != OM_DS ? age() : 0;
+      MILIA_PROBE3(select__case, m_om, m_ov, stats_case());
+      compute_invariants();
+      m_uage.reset();
+      m_udm.reset();
+      m_udl.reset();
     }
 
     void flrw_nat::set_vacuum(double vacuum)
@@ -146,7 +183,57 @@ namespace milia
       m_crit = B;
       m_kap = (m_ok > 0 ? -1 : 1);
       m_case = select_case();
-      m_uage = m_case != OM_DS ? age(0) : 0;
+      MILIA_PROBE3(select__case, m_om, m_ov, stats_case());
+      compute_invariants();
+      m_uage.reset();
+      m_udm.reset();
+      m_udl.reset();
+    }
+
+    void flrw_nat::set_parameters(double matter, double vacuum)
+    {
+      // The checks and the invariants of the constructor, the
+      // assignment does not throw
+      flrw_nat other(matter, vacuum);
+      other.set_accuracy(m_acc);
+      *this = other;
+    }
+
+    void flrw_nat::set_accuracy(accuracy acc)
+    {
+      m_acc = acc;
+      m_tol = get_tolerances(acc);
+      // the elliptic integrals at z = 0 and the current age
+      // depend on the tolerances
+      compute_invariants();
+      m_uage.reset();
+      m_udm.reset();
+      m_udl.reset();
+    }
+
+    double flrw_nat::ellint_first(double k, double phi) const
+    {
+      if (m_acc == ACCURACY_REFERENCE)
+        return boost::math::ellint_1(k, phi);
+      return ellint_f(k, phi, m_tol.ellint);
+    }
+
+    double flrw_nat::ellint_third(double k, double n, double phi) const
+    {
+      if (m_acc == ACCURACY_REFERENCE)
+        return boost::math::ellint_3(k, n, phi);
+      return ellint_pi(k, n, phi, m_tol.ellint);
+    }
+
+    double flrw_nat::uage() const
+    {
+      double res;
+      if (!m_uage.get(res))
+      {
+        res = m_case != OM_DS ? age(0) : 0;
+        m_uage.set(res);
+      }
+      return res;
     }
 
     flrw_nat::ComputationCases flrw_nat::select_case() const
@@ -189,6 +276,55 @@ namespace milia
       return NO_CASE;
     }
 
+    void flrw_nat::compute_invariants()
+    {
+      switch (m_case)
+      {
+        case A1:
+        {
+          m_sup = m_om / abs(m_ok);
+          const double v = cbrt(m_kap * (m_crit - 1) + sqrt(m_crit * (m_crit
+              - 2)));
+          m_y1 = (-1 + m_kap * (v + 1. / v)) / 3.;
+          m_A = sqrt(m_y1 * (3 * m_y1 + 2));
+          m_g = 1. / sqrt(m_A);
+          m_k = sqrt(0.5 + 0.25 * pow<2> (m_g) * (v + 1. / v));
+          m_n10 = pow<2> (m_A + m_kap * m_y1) / (4 * m_A * m_kap * m_y1);
+          m_phi0 = acos((m_sup + m_kap * m_y1 - m_A) / (m_sup + m_kap * m_y1
+              + m_A));
+          m_ellint0 = ellint_first(m_k, m_phi0);
+          break;
+        }
+        case A2_1:
+        case A2_2:
+        {
+          m_sup = m_om / abs(m_ok);
+          const double arg0 = acos(1 - m_crit) / 3.;
+          m_y1 = (-1. + cos(arg0) + FLRW_SQRT3 * sin(arg0)) / 3.;
+          m_y2 = (-1. - 2. * cos(arg0)) / 3.;
+          m_y3 = (-1. + cos(arg0) - FLRW_SQRT3 * sin(arg0)) / 3.;
+          m_g = 2. / sqrt(m_y1 - m_y2);
+          m_k = sqrt((m_y1 - m_y3) / (m_y1 - m_y2));
+          m_phi0 = asin(sqrt((m_y1 - m_y2) / (m_sup + m_y1)));
+          m_ellint0 = ellint_first(m_k, m_phi0);
+          break;
+        }
+        case OM_OV_1:
+        {
+          const double arg0 = cbrt((1 / m_om - 1));
+          m_down = 1 + (1 + FLRW_SQRT3) * arg0;
+          m_up = 1 + (1 - FLRW_SQRT3) * arg0;
+          m_g = 1. / (FLRW_4THRT3 * sqrt(m_om) * sqrt(arg0));
+          m_k = sqrt(0.5 + 0.25 * FLRW_SQRT3);
+          m_phi0 = acos(m_up / m_down);
+          m_ellint0 = ellint_first(m_k, m_phi0);
+          break;
+        }
+        default:
+          break;
+      }
+    }
+
     double flrw_nat::get_hubble(double z) const
     {
       return sqrt(m_om * pow<3> (1 + z) + m_ok * pow<2> (1 + z) + m_ov);
@@ -202,7 +338,7 @@ namespace milia
         case OM_DS:
          return log(1 + z);
         default:
-         return m_uage - age(z);
+         return uage() - age(z);
       }
     }
 
@@ -230,11 +366,203 @@ namespace milia
         case OM_OV_1: // Flat
           return pow<3> (dm) / 3.0;
         default:
+          if (abs(m_ok * pow<2> (dm)) < m_tol.vol_series)
+          {
+            stats::detail::count_path(stats::PATH_VOL_SERIES);
+            return vol_series(m_ok, dm);
+          }
           return (dm * sqrt(1 + m_ok * pow<2> (dm)) - asinc(m_kap,
               m_sqok, dm)) / (2 * m_ok);
       }
     }
 
+    void flrw_nat::lt(const double* z, double* res, std::size_t n) const
+    {
+      switch(m_case) {
+        case OM_DS:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = vmath::log1p(z[i]);
+          break;
+        default:
+        {
+          const double ua = uage();
+          age(z, res, n);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = ua - res[i];
+        }
+      }
+    }
+
+    void flrw_nat::dm(const double* z, double* res, std::size_t n) const
+    {
+      dl(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] /= 1 + z[i];
+    }
+
+    void flrw_nat::da(const double* z, double* res, std::size_t n) const
+    {
+      dl(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] /= pow<2> (1 + z[i]);
+    }
+
+    void flrw_nat::dc(const double* z, double* res, std::size_t n) const
+    {
+      dm(z, res, n);
+      dc_from_dm(res, res, n);
+    }
+
+    void flrw_nat::vol(const double* z, double* res, std::size_t n) const
+    {
+      dm(z, res, n);
+      vol_from_dm(res, res, n);
+    }
+
+    void flrw_nat::dc_from_dm(const double* dm, double* res, std::size_t n) const
+    {
+      switch (m_case)
+      {
+        // Flat cases
+        case OV_EDS: // EdS
+        case OM_DS: // dS
+        case OM_OV_1: // Flat
+          std::copy(dm, dm + n, res);
+          break;
+        default:
+        {
+          const double sqok = m_sqok;
+          if (m_kap == 1)
+            for (std::size_t i = 0; i < n; ++i)
+              res[i] = vmath::asin(sqok * dm[i]) / sqok;
+          else
+            for (std::size_t i = 0; i < n; ++i)
+              res[i] = vmath::asinh(sqok * dm[i]) / sqok;
+        }
+      }
+    }
+
+    void flrw_nat::vol_from_dm(const double* dm, double* res, std::size_t n) const
+    {
+      switch (m_case)
+      {
+        // Flat cases
+        case OV_EDS: // EdS
+        case OM_DS: // dS
+        case OM_OV_1: // Flat
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = pow<3> (dm[i]) / 3.0;
+          break;
+        default:
+        {
+          const double ok = m_ok;
+          const double sqok = m_sqok;
+          const double limit = m_tol.vol_series;
+          const bool count = stats::detail::counting();
+          std::size_t nseries = 0;
+          // the closed form goes to a buffer, the series are computed
+          // in a second pass over the few elements that need them
+          for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+          {
+            const std::size_t w = std::min(FLRW_BLOCK, n - i);
+            const double* lm = dm + i;
+            double cf[FLRW_BLOCK];
+            if (m_kap == 1)
+              for (std::size_t l = 0; l < w; ++l)
+                cf[l] = (lm[l] * sqrt(1 + ok * pow<2> (lm[l]))
+                    - vmath::asin(sqok * lm[l]) / sqok) / (2 * ok);
+            else
+              for (std::size_t l = 0; l < w; ++l)
+                cf[l] = (lm[l] * sqrt(1 + ok * pow<2> (lm[l]))
+                    - vmath::asinh(sqok * lm[l]) / sqok) / (2 * ok);
+            // before res, that may be the same array as dm
+            if (count)
+              for (std::size_t l = 0; l < w; ++l)
+                nseries += abs(ok * pow<2> (lm[l])) < limit;
+            for (std::size_t l = 0; l < w; ++l)
+              res[i + l] = abs(ok * pow<2> (lm[l])) < limit
+                  ? vol_series(ok, lm[l]) : cf[l];
+          }
+          stats::detail::count_path(stats::PATH_VOL_SERIES, nseries);
+        }
+      }
+    }
+
+    void flrw_nat::eval(double z, unsigned mask, quantity_values& res) const
+    {
+      if (mask & (Q_DL | Q_DA | Q_DM | Q_DC | Q_VOL))
+      {
+        const double l = dl(z);
+        const double m = dm(z, l);
+        if (mask & Q_DL)
+          res.dl = l;
+        if (mask & Q_DA)
+          res.da = da(z, l);
+        if (mask & Q_DM)
+          res.dm = m;
+        if (mask & Q_DC)
+          res.dc = dc(z, m);
+        if (mask & Q_VOL)
+          res.vol = vol(z, m);
+      }
+      if (mask & Q_AGE)
+      {
+        res.age = age(z);
+        if (mask & Q_LT)
+          res.lt = m_case == OM_DS ? log(1 + z) : uage() - res.age;
+      }
+      else if (mask & Q_LT)
+        res.lt = lt(z);
+    }
+
+    void flrw_nat::eval(const double* z, std::size_t n, unsigned mask,
+        const quantity_columns& res) const
+    {
+      const bool distances = mask & (Q_DL | Q_DA | Q_DM | Q_DC | Q_VOL);
+      const bool times = mask & (Q_AGE | Q_LT);
+      double l[FLRW_BLOCK], m[FLRW_BLOCK], t[FLRW_BLOCK];
+      const double ua = (mask & Q_LT) && m_case != OM_DS ? uage() : 0;
+      for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+      {
+        const std::size_t w = std::min(FLRW_BLOCK, n - i);
+        const double* zb = z + i;
+        if (distances)
+        {
+          dl(zb, l, w);
+          for (std::size_t j = 0; j < w; ++j)
+            m[j] = l[j] / (1 + zb[j]);
+          if (mask & Q_DL)
+            std::copy(l, l + w, res.dl + i);
+          if (mask & Q_DA)
+            for (std::size_t j = 0; j < w; ++j)
+              res.da[i + j] = l[j] / pow<2> (1 + zb[j]);
+          if (mask & Q_DM)
+            std::copy(m, m + w, res.dm + i);
+          if (mask & Q_DC)
+            dc_from_dm(m, res.dc + i, w);
+          if (mask & Q_VOL)
+            vol_from_dm(m, res.vol + i, w);
+        }
+        if (times)
+        {
+          if (m_case == OM_DS)
+          {
+            if (mask & Q_AGE)
+              age(zb, res.age + i, w);
+            if (mask & Q_LT)
+              lt(zb, res.lt + i, w);
+            continue;
+          }
+          age(zb, t, w);
+          if (mask & Q_AGE)
+            std::copy(t, t + w, res.age + i);
+          if (mask & Q_LT)
+            for (std::size_t j = 0; j < w; ++j)
+              res.lt[i + j] = ua - t[j];
+        }
+      }
+    }
+
 } //namespace milia
 
 std::ostream& operator<<(std::ostream& os, milia::flrw_nat& iflrw)
@@ -245,9 +573,9 @@ std::ostream& operator<<(std::ostream& os, milia::flrw_nat& iflrw)
 
 namespace milia {
   namespace rei {
-    flrw_nat::flrw_nat(double m, double v) 
+    flrw_nat::flrw_nat(double m, double v) :
+      m_model(m, v)
     {
-      m_impl.reset(impl::flrw_nat_impl::construct(m, v));
     }
 }
 }
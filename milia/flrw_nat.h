@@ -24,8 +24,12 @@
 #include <string>
 #include <ostream>
 #include <memory>
+#include <cstddef>
 
+#include "accuracy.h"
+#include "lazy.h"
 #include "flrw_nat_impl.h"
+#include "quantities.h"
 
 namespace milia
 {
@@ -42,6 +46,12 @@ namespace milia
      * Distances are computed from the luminosity distance using
      * <a href="http://xxx.unizar.es/abs/astro-ph/0002334">%astro-ph/0002334</a>
      * without inhomogeneities.
+     *
+     * Thread safety: the const methods do not modify any global state
+     * and do not allocate memory, they can be called concurrently on the
+     * same object. The only member they write is the current age, which
+     * is computed on first use and stored atomically. The non-const
+     * methods need exclusive access to the object.
      */
     class flrw_nat
     {
@@ -113,6 +123,38 @@ namespace milia
          */
         void set_vacuum(double vacuum);
 
+        /**
+         * Set the values of the matter density and of the vacuum
+         * energy density
+         *
+         * The parameters are checked and the terms that depend on them
+         * are computed once, as in the constructor. The current age is
+         * computed on first use. If the parameters are not valid, the
+         * object is not modified.
+         *
+         * @param matter matter density
+         * @param vacuum vacuum energy density
+         * @throws std::domain_error if the parameters are not valid
+         */
+        void set_parameters(double matter, double vacuum);
+
+        /**
+         * Set the accuracy policy of the computations
+         *
+         * The default is ACCURACY_REFERENCE. The policy is kept when the
+         * parameters change and when the object is copied. To use other
+         * policy in a single call, set it in a copy of the object,
+         * the copy does not allocate.
+         *
+         * @param acc accuracy policy
+         */
+        void set_accuracy(accuracy acc);
+
+        /**
+         * Get the accuracy policy of the computations
+         */
+        accuracy get_accuracy() const;
+
         /**
          * Computes the Hubble parameter at redshift z
          *
@@ -192,6 +234,220 @@ namespace milia
          */
         double lt(double z) const;
 
+        /**
+         * Comoving distance (line of sight) for an array of redshifts
+         *
+         * The computation case is resolved once for the whole array.
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dc(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Comoving distance (transverse) for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dm(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Angular distance for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void da(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Luminosity distance for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dl(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Comoving volume per solid angle for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the volumes are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void vol(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Age of the Universe for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the ages are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void age(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Look-back time for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the times are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void lt(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Computes several quantities with a single evaluation of the
+         * luminosity distance and of the age.
+         * Q_MODULUS and Q_ANGULAR_SCALE are ignored in natural units.
+         *
+         * @param z redshift
+         * @param mask quantities to compute, a combination of milia::quantity
+         * @param res where the requested quantities are stored
+         */
+        void eval(double z, unsigned mask, quantity_values& res) const;
+
+        /**
+         * Computes several quantities for an array of redshifts with a single
+         * evaluation of the luminosity distance and of the age per redshift.
+         * Q_MODULUS and Q_ANGULAR_SCALE are ignored in natural units.
+         *
+         * @param z array of redshifts
+         * @param n number of elements in z and in the output arrays
+         * @param mask quantities to compute, a combination of milia::quantity
+         * @param res arrays where the requested quantities are stored,
+         * they must not overlap z or each other
+         */
+        void eval(const double* z, std::size_t n, unsigned mask,
+            const quantity_columns& res) const;
+
+        /**
+         * Redshift at a given luminosity distance
+         *
+         * In closed models where the luminosity distance is not monotonic,
+         * one of the redshifts is returned.
+         *
+         * @param dl luminosity distance
+         * @return redshift
+         * @throws std::domain_error if no redshift has this distance
+         */
+        double z_from_dl(double dl) const;
+
+        /**
+         * Redshift at a given comoving distance (line of sight)
+         *
+         * @param dc line of sight comoving distance
+         * @return redshift
+         * @throws std::domain_error if no redshift has this distance
+         */
+        double z_from_dc(double dc) const;
+
+        /**
+         * Redshift at a given comoving distance (transverse)
+         *
+         * In closed models, the lowest redshift with this distance.
+         *
+         * @param dm transverse comoving distance
+         * @return redshift
+         * @throws std::domain_error if no redshift has this distance
+         */
+        double z_from_dm(double dm) const;
+
+        /**
+         * Redshift at a given comoving volume per solid angle
+         *
+         * @param vol comoving volume per solid angle
+         * @return redshift
+         * @throws std::domain_error if no redshift has this volume
+         */
+        double z_from_vol(double vol) const;
+
+        /**
+         * Redshift at a given age of the Universe
+         *
+         * @param age age of the Universe, 0 < age <= age()
+         * @return redshift
+         * @throws std::domain_error if no redshift has this age
+         * and in the de Sitter Universe
+         */
+        double z_from_age(double age) const;
+
+        /**
+         * Redshift at a given look-back time
+         *
+         * @param lt look-back time
+         * @return redshift
+         * @throws std::domain_error if no redshift has this look-back time
+         */
+        double z_from_lt(double lt) const;
+
+        /**
+         * Redshifts at an array of luminosity distances
+         *
+         * The array versions of the inverses build a table of the
+         * quantity on a grid of redshifts, interpolate it and
+         * refine the redshifts with Newton's method.
+         *
+         * @param dl array of luminosity distances
+         * @param res array where the redshifts are stored, must not overlap dl
+         * @param n number of elements in dl and res
+         * @throws std::domain_error if no redshift has one of the distances
+         */
+        void z_from_dl(const double* dl, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of comoving distances (line of sight)
+         *
+         * @param dc array of line of sight comoving distances
+         * @param res array where the redshifts are stored, must not overlap dc
+         * @param n number of elements in dc and res
+         * @throws std::domain_error if no redshift has one of the distances
+         */
+        void z_from_dc(const double* dc, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of comoving distances (transverse)
+         *
+         * @param dm array of transverse comoving distances
+         * @param res array where the redshifts are stored, must not overlap dm
+         * @param n number of elements in dm and res
+         * @throws std::domain_error if no redshift has one of the distances
+         */
+        void z_from_dm(const double* dm, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of comoving volumes per solid angle
+         *
+         * @param vol array of comoving volumes per solid angle
+         * @param res array where the redshifts are stored, must not overlap vol
+         * @param n number of elements in vol and res
+         * @throws std::domain_error if no redshift has one of the volumes
+         */
+        void z_from_vol(const double* vol, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of ages of the Universe
+         *
+         * @param age array of ages of the Universe
+         * @param res array where the redshifts are stored, must not overlap age
+         * @param n number of elements in age and res
+         * @throws std::domain_error if no redshift has one of the ages
+         */
+        void z_from_age(const double* age, double* res, std::size_t n) const;
+
+        /**
+         * Redshifts at an array of look-back times
+         *
+         * @param lt array of look-back times
+         * @param res array where the redshifts are stored, must not overlap lt
+         * @param n number of elements in lt and res
+         * @throws std::domain_error if no redshift has one of the times
+         */
+        void z_from_lt(const double* lt, double* res, std::size_t n) const;
+
         /**
          * String with characteristics of the FLRW universe (Hubble parameter,
          * Matter density, vacuum energy density.
@@ -201,6 +457,8 @@ namespace milia
         std::string to_string() const;
 
       private:
+        // Reads the case and the invariants of the flat models
+        friend class flrw_ensemble;
 
         // Matter density
         double m_om;
@@ -218,8 +476,14 @@ namespace milia
         double m_sqok;
         // Negative of the sign of the curvature parameter
         short m_kap;
-        // Current Universe age (may be infinity in certain models)
-        double m_uage;
+        // Current Universe age (may be infinity in certain models),
+        // computed on first use by uage
+        detail::lazy_double m_uage;
+        double uage() const;
+        // Ends of the ranges of u = log(1 + z) where dm (and dc and vol)
+        // and dl increase, computed on first use by u_increasing
+        detail::lazy_double m_udm;
+        detail::lazy_double m_udl;
 
         enum ComputationCases
         {
@@ -238,20 +502,81 @@ namespace milia
 
         ComputationCases m_case;
         ComputationCases select_case() const;
+        // Index of the case in milia/stats.h
+        std::size_t stats_case() const
+        {
+          return m_case - 1;
+        }
+
+        // Terms that depend only on om and ov, updated
+        // by compute_invariants when the parameters change
+        // om / abs(m_ok)
+        double m_sup;
+        // Roots of the cubic polynomial in the non flat cases
+        double m_y1;
+        double m_y2;
+        double m_y3;
+        // Auxiliary term in case A1
+        double m_A;
+        // Scale and modulus of the elliptic integrals
+        double m_g;
+        double m_k;
+        // Characteristic of equation 10 in case A1
+        double m_n10;
+        // Arguments of acos in the flat case
+        double m_up;
+        double m_down;
+        // Amplitude and elliptic integral of the luminosity distance at z = 0
+        double m_phi0;
+        double m_ellint0;
+        void compute_invariants();
+
+        // Accuracy policy and its tolerances
+        accuracy m_acc;
+        tolerances m_tol;
+        // Elliptic integrals of the first and third kind with the
+        // tolerance of the policy, boost::math at ACCURACY_REFERENCE
+        double ellint_first(double k, double phi) const;
+        double ellint_third(double k, double n, double phi) const;
 
         // Distances and volumes from other distance
         double da(double z, double dl) const;
         double dc(double z, double dm) const;
         double dm(double z, double dl) const;
         double vol(double z, double dm) const;
+        // Array versions, res may be the same array as dm
+        void dc_from_dm(const double* dm, double* res, std::size_t n) const;
+        void vol_from_dm(const double* dm, double* res, std::size_t n) const;
 
         // Methods to compute the age in different cases
         double tolz(double z) const;
         double tomz(double z) const;
         double ta1(double z) const;
+        // Equation 10 of case A1, given F(phi, k) and Pi(n10; phi, k)
+        double ta1_eq10(double z, double f1, double f3) const;
+        // Case A1 at the node of equation 10
+        double ta1_node(double z) const;
         double ta2(double z) const;
         double tb(double z) const;
-        double ti(double z) const;
+
+        // Inverses without a closed form, q is Q_DL, Q_DC, Q_VOL, Q_LT
+        // or Q_AGE. They work in u = log(1 + z) with an increasing
+        // function f(u) (minus the age for Q_AGE)
+        // f and df/du at z
+        double z_forward(quantity q, double z, double& deriv) const;
+        void z_forward(quantity q, const double* z, double* f,
+            double* deriv, std::size_t n) const;
+        // Comoving distance in units of the radius of curvature,
+        // in the closed models, without the reduction of asin
+        double chi(double z) const;
+        // End of the range of u where f increases, FLRW_INV_UMAX
+        // except for the distances of the closed models
+        double u_increasing(quantity q) const;
+        // Newton's method with bisection inside a bracket
+        double z_solve(quantity q, double y) const;
+        // Table of f, interpolation and Newton's method in blocks
+        void z_solve(quantity q, const double* y, double* res,
+            std::size_t n) const;
     };
 
     inline double flrw_nat::get_matter() const
@@ -264,6 +589,11 @@ namespace milia
       return m_ov;
     }
 
+    inline accuracy flrw_nat::get_accuracy() const
+    {
+      return m_acc;
+    }
+
     inline double flrw_nat::dc(double z) const
     {
       return dc(z, dm(z));
@@ -22,62 +22,51 @@
 #include <config.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
-#include <boost/math/special_functions/ellint_1.hpp>
-#include <boost/math/special_functions/ellint_3.hpp>
 #include <boost/math/special_functions/asinh.hpp>
 #include <boost/math/special_functions/atanh.hpp>
-#include <boost/math/special_functions/cbrt.hpp>
 #include <boost/math/special_functions/pow.hpp>
-#include <gsl/gsl_errno.h>
-#include <gsl/gsl_integration.h>
-#include <gsl/gsl_sf_ellint.h>
 
+#include "closed_form.h"
+#include "ellint.h"
 #include "flrw_nat.h"
 #include "flrw_prec.h"
+#include "probes.h"
+#include "stats_hooks.h"
+#include "util.h"
+#include "vmath.h"
 
 using std::sqrt;
 using std::atan;
 using std::log;
 using std::abs;
+using std::sin;
+using std::acos;
+using std::asin;
 
-using boost::math::ellint_1;
-using boost::math::ellint_3;
 using boost::math::asinh;
 using boost::math::atanh;
-using boost::math::cbrt;
 using boost::math::pow;
 
-namespace
-{
-  //const double M_SQRT3 = sqrt(3);
-  const double M_4THRT3 = sqrt(M_SQRT3);
-  double helper_fun_time(double z, void* pars)
-  {
-    milia::flrw_nat* pmetric =
-        static_cast<milia::flrw_nat*> (pars);
-    const double om = pmetric->get_matter();
-    const double ol = pmetric->get_vacuum();
-    return 1. / ((1 + z) * (sqrt(pow<2> (1 + z) * (1 + om * z) - z * ol * (2
-        + z))));
-  }
-}
-
 namespace milia
 {
     double flrw_nat::age() const
     {
-      return m_uage;
+      return uage();
     }
 
     double flrw_nat::age(double z) const
     {
+      const detail::age_probe probe(z, stats_case());
+      const stats::detail::kernel_scope scope(stats_case(),
+          stats::KERNEL_AGE, 1);
       switch (m_case)
       {
         case OM_OV_0:
-          return 1.0 / (1 + z);
+          return closed_form::empty_age(z);
           break;
         case OV_1:
         case OV_2:
@@ -101,24 +90,143 @@ namespace milia
       return -1;
     }
 
+    // Age, array version
+    // The case and the z-independent terms are computed only once
+    void flrw_nat::age(const double* z, double* res, std::size_t n) const
+    {
+      const detail::age_array_probe probe(n, stats_case());
+      const stats::detail::kernel_scope scope(stats_case(),
+          stats::KERNEL_AGE, n);
+      switch (m_case)
+      {
+        case OM_OV_0:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 1.0 / (1 + z[i]);
+          break;
+        case OV_1:
+        {
+          // local copies, the loops do not vectorize with members
+          const double om = m_om;
+          const double pre0 = 1 - om;
+          const double sq0 = sqrt(pre0);
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            const double prez = sqrt(1 + om * z[i]);
+            res[i] = (prez / (1 + z[i]) - om / sq0 * vmath::atanh(sq0 / prez))
+                / pre0;
+          }
+          break;
+        }
+        case OV_2:
+        {
+          const double om = m_om;
+          const double pre0 = 1 - om;
+          const double sq0 = sqrt(-pre0);
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            const double prez = sqrt(1 + om * z[i]);
+            res[i] = (prez / (1 + z[i]) - om / sq0 * vmath::atan(sq0 / prez))
+                / pre0;
+          }
+          break;
+        }
+        case OV_EDS:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 2 / (3 * (1 + z[i]) * sqrt(1 + z[i]));
+          break;
+        case OM:
+        {
+          const double pre = sqrt(1 / m_ov - 1);
+          const double sq = sqrt(m_ov);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = vmath::asinh(1 / ((1 + z[i]) * pre)) / sq;
+          break;
+        }
+        case A1:
+          // Equation 10 is evaluated in blocks, the special
+          // cases near the nodes go through the scalar version
+        {
+          std::size_t neq10 = 0;
+          std::size_t nprincipal = 0;
+          for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+          {
+            const std::size_t w = std::min(FLRW_BLOCK, n - i);
+            double phi[FLRW_BLOCK], f1[FLRW_BLOCK], f3[FLRW_BLOCK];
+            for (std::size_t l = 0; l < w; ++l)
+            {
+              const double arg0 = m_kap * m_y1 + m_om * (1 + z[i + l]) / abs(
+                  m_ok);
+              phi[l] = vmath::acos((arg0 - m_A) / (arg0 + m_A));
+            }
+            ellint_f(m_k, phi, f1, w, m_tol.ellint);
+            ellint_pi(m_k, m_n10, phi, f3, w, m_tol.ellint);
+            for (std::size_t l = 0; l < w; ++l)
+            {
+              const double crit10 = 1 - m_n10 * pow<2> (sin(phi[l]));
+              if (abs(crit10) < FLRW_NODE_TOL)
+                res[i + l] = ta1(z[i + l]);
+              else
+              {
+                res[i + l] = ta1_eq10(z[i + l], f1[l], f3[l]);
+                ++(crit10 < 0 ? nprincipal : neq10);
+              }
+            }
+          }
+          stats::detail::count_path(stats::PATH_A1_EQ10, neq10);
+          stats::detail::count_path(stats::PATH_A1_PRINCIPAL, nprincipal);
+          break;
+        }
+        case A2_1:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = ta2(z[i]);
+          break;
+        case A2_2:
+        {
+          const double arg3 = m_y1 - m_y2;
+          const double nn = -m_y1 / arg3;
+          const double pre = 2 * m_om / (m_y1 * abs(m_ok) * sqrt(-arg3
+              * m_ok));
+          for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+          {
+            const std::size_t w = std::min(FLRW_BLOCK, n - i);
+            double phi[FLRW_BLOCK], f1[FLRW_BLOCK], f3[FLRW_BLOCK];
+            for (std::size_t l = 0; l < w; ++l)
+              phi[l] = vmath::asin(sqrt(arg3 / (m_y1 - m_om * (1 + z[i + l])
+                  / m_ok)));
+            ellint_f(m_k, phi, f1, w, m_tol.ellint);
+            ellint_pi(m_k, nn, phi, f3, w, m_tol.ellint);
+            for (std::size_t l = 0; l < w; ++l)
+              res[i + l] = pre * (f3[l] - f1[l]);
+          }
+          break;
+        }
+        case OM_OV_1:
+        {
+          const double pre = 2. / (3. * sqrt(1 - m_om));
+          const double arg = 1. / m_om - 1;
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = pre * vmath::asinh(sqrt(arg / pow<3> (1 + z[i])));
+          break;
+        }
+        default:
+          std::fill(res, res + n, -1.);
+      }
+    }
+
     // ol = 0 CASE: OV_1, OV_2, OV_EDS
     double flrw_nat::tolz(double z) const
     {
-      const double pre0 = 1 - m_om;
-      const double prez = sqrt(1 + m_om * z);
       switch (m_case)
       {
         case OV_1:
           //ov = 0 0 < om < 1
-          return (prez / (1 + z) - m_om / sqrt(pre0) * atanh(sqrt(pre0) / prez))
-              / pre0;
+          return closed_form::open_matter_age(m_om, z);
         case OV_2:
           //ol = 0 om > 1
-          return (prez / (1 + z) - m_om / sqrt(-pre0)
-              * atan(sqrt(-pre0) / prez)) / pre0;
+          return closed_form::closed_matter_age(m_om, z);
         case OV_EDS:
           // ol = 0 om = 1
-          return 2 / (3 * (1 + z) * sqrt(1 + z));
+          return closed_form::eds_age(z);
       }
       return -1.;
     }
@@ -126,96 +234,85 @@ namespace milia
     // om=0 CASE: OM
     double flrw_nat::tomz(double z) const
     {
-      return asinh(1 / ((1 + z) * sqrt(1 / m_ov - 1))) / sqrt(m_ov);
+      return closed_form::vacuum_age(m_ov, z);
     }
 
     // CASE A1
     double flrw_nat::ta1(double z) const
     {
-      const double vk = cbrt(m_kap * (m_crit - 1) + sqrt(m_crit * (m_crit - 2)));
-      const double y1 = (m_kap * (vk + 1 / vk) - 1) / 3.;
-      const double A = sqrt(y1 * (3 * y1 + 2));
       // Parameters of the elliptical functions
-      const double k = sqrt((2 * A + m_kap * (1 + 3 * y1)) / (4 * A));
-      double arg0 = m_kap * y1 + m_om * (1 + z) / abs(m_ok);
-      double phi = acos((arg0 - A) / (arg0 + A));
-
-      // Selecting between cases
-      // these conditions must hold
-      // abs(k) <= 1 and n * pow<2>(sin(phi_z)) < 1
-
-      const double sin_phi = sin(phi);
-      const double n_10 = pow<2> (A + m_kap * y1) / (4 * A * m_kap * y1);
-      const double n_8 = y1 * (1 + y1) / pow<2> (A - m_kap * y1);
+      const double k = m_k;
+      const double arg0 = m_kap * m_y1 + m_om * (1 + z) / abs(m_ok);
+      const double phi = acos((arg0 - m_A) / (arg0 + m_A));
 
-      double arg2, arg3;
-      double hm, hp;
-      double pre;
-      double arg1 = (1 + z) * m_om / m_ok;
-
-      const double crit8 = 1 - n_8 * pow<2> (sin_phi);
-      const double crit10 = 1 - n_10 * pow<2> (sin_phi);
-      // If there's a node in eq 10, try eq 8
-      if (abs(crit10) < FLRW_EQ_TOL)
+      // Equation 10 has a node where crit10 = 0
+      // Equations 8 and 22 at the node do not agree with the
+      // integral of the age, the node is handled by ta1_node
+      const double crit10 = 1 - m_n10 * pow<2> (sin(phi));
+      if (abs(crit10) < FLRW_NODE_TOL)
       {
-        // check if there's a node in eq 8 also, try eq 22 if so
-        if (abs(crit8) < FLRW_EQ_TOL)
-        {
-          //  Equation 22, a very special case of b = 27*(2+sqrt(2))/8.
-          phi = acos(-1 - arg1 / M_SQRT2 + 1 - arg1);
-          //      std::cout << "eq 22" << std::endl;
-          const double arg2 = (1 - arg1) * sqrt(arg1 * arg1
-              + (arg1 + M_SQRT1_2) * (1 + M_SQRT1_2));
-          const double arg3 = (M_SQRT2 - 1) * (arg1 + M_SQRT2 + 1) * sqrt((1
-              + M_SQRT1_2) * (M_SQRT1_2 - arg1));
-          return 0.25 / sqrt(m_ov) * ((M_SQRT2 - 1) * ellint_1(0.5 * sqrt(1 + 2
-              * M_SQRT2), phi) + log(abs((arg2 + arg3) / (arg2 - arg3))));
-        }
-        //        EQUATION 8.
-        // if the critical parameter is negative, we have imaginary terms
-        // for the moment we must integrate
-        else if (crit8 < 0)
-        {
-          return ti(z);
-
-        }
-        // if not, go ahead with equation 8
-        else
-        {
-          //       std::cout << "eq 8" << std::endl;
-          arg2 = arg1 * arg1 * (1 + arg1);
-          arg2 = sqrt((1 + y1) * ((1 + y1) * pow<2> (y1) - arg2));
-          arg2 *= 2 * m_kap * y1;
-          arg1 *= arg1 * (A - m_kap * y1) - 2 * m_kap * (1 + y1) * pow<2> (y1);
-          hm = arg1 - arg2;
-          hp = arg1 + arg2;
-          arg1 = ellint_1(k, phi) / (m_kap * y1 * sqrt(A));
-          arg2 = (A - m_kap) / (y1 * (1 + y1) * sqrt(A))
-              * ellint_3(k, n_8, phi);
-          arg3 = log(abs(hm / hp)) / (m_kap * y1 * sqrt(m_kap * (y1 + 1)));
-          pre = 0.5 * m_om / (abs(m_ok) * m_sqok);
-          return pre * (arg1 + arg2 + arg3);
-        }
+        MILIA_PROBE3(age__branch, z, stats_case(), stats::PATH_A1_NODE);
+        stats::detail::count_path(stats::PATH_A1_NODE);
+        return ta1_node(z);
       }
+      // Past the node of eq 10, the integral of the third kind
+      // is the Cauchy principal value
       else if (crit10 < 0)
       {
-        return ti(z);
+        MILIA_PROBE3(age__branch, z, stats_case(), stats::PATH_A1_PRINCIPAL);
+        stats::detail::count_path(stats::PATH_A1_PRINCIPAL);
+        return ta1_eq10(z, ellint_first(k, phi), ellint_pi(k, m_n10, phi,
+            m_tol.ellint));
       }
-
       else
       {
         // Equation 10
-        //        std::cout << "eq 10" << std::endl;
-        hm = sqrt(((1 + y1) * (y1 - arg1)) / (pow<2> (y1) + (1 + arg1) * (y1
-            + arg1)));
-        arg1 = -ellint_1(k, phi) / (A + m_kap * y1);
-        arg2 = -0.5 * (A - m_kap * y1) / (m_kap * y1 * (A + m_kap * y1))
-            * ellint_3(k, n_10, phi);
-        arg3 = -0.5 * (sqrt(A / (m_kap * (y1 + 1))) / (m_kap * y1)) * log(abs(
-            (1.0 - hm) / (1.0 + hm)));
-        return m_om / (sqrt(A * abs(pow<3> (m_ok)))) * (arg1 + arg2 + arg3);
+        MILIA_PROBE3(age__branch, z, stats_case(), stats::PATH_A1_EQ10);
+        stats::detail::count_path(stats::PATH_A1_EQ10);
+        return ta1_eq10(z, ellint_first(k, phi), ellint_third(k, m_n10,
+            phi));
       }
-      return -1.0;
+    }
+
+    // Near the node of equation 10 the terms with Pi and with the
+    // logarithm diverge with opposite signs, but the age is smooth.
+    // Eq 10 is used at z + h, out of the band, and the short
+    // interval to z is integrated with a fixed rule
+    double flrw_nat::ta1_node(double z) const
+    {
+      double zh = z;
+      double phi = 0;
+      // z - h if z + h is also in the band
+      for (int side = 1; side >= -1; side -= 2)
+      {
+        zh = z + side * FLRW_NODE_STEP * (1 + z);
+        const double arg0 = m_kap * m_y1 + m_om * (1 + zh) / abs(m_ok);
+        phi = acos((arg0 - m_A) / (arg0 + m_A));
+        if (abs(1 - m_n10 * pow<2> (sin(phi))) >= FLRW_NODE_TOL)
+          break;
+      }
+      if (stats::detail::counting())
+        stats::detail::add(stats::detail::local().intervals, 1);
+      return ta1_eq10(zh, ellint_f(m_k, phi, m_tol.ellint), ellint_pi(m_k,
+          m_n10, phi, m_tol.ellint))
+          + age_interval(m_om, m_ov, z, zh);
+    }
+
+    double flrw_nat::ta1_eq10(double z, double f1, double f3) const
+    {
+      const double y1 = m_y1;
+      const double A = m_A;
+      const double arg1 = (1 + z) * m_om / m_ok;
+      const double den = pow<2> (y1) + (1 + arg1) * (y1 + arg1);
+      const double hm = sqrt(((1 + y1) * (y1 - arg1)) / den);
+      // 1 - hm^2 without cancellation, hm -> 1 near the node
+      const double hm2c = arg1 * (2 * (1 + y1) + arg1) / den;
+      const double arg2 = -f1 / (A + m_kap * y1);
+      const double arg3 = -0.5 * (A - m_kap * y1) / (m_kap * y1 * (A + m_kap
+          * y1)) * f3;
+      const double arg4 = -0.5 * (sqrt(A / (m_kap * (y1 + 1))) / (m_kap * y1))
+          * log(abs(hm2c) / pow<2> (1.0 + hm));
+      return m_om / (sqrt(A * abs(pow<3> (m_ok)))) * (arg2 + arg3 + arg4);
     }
 
     double flrw_nat::ta2(double z) const
@@ -224,24 +321,19 @@ namespace milia
       if (m_case == A2_1)
       {
         const double arg = (1 + z) * m_om / m_ok;
-        return -(M_SQRT3 * log(1 - 2 / (sqrt(1. / 3. - arg) + 1)) + log(1 + 2
+        return -(FLRW_SQRT3 * log(1 - 2 / (sqrt(1. / 3. - arg) + 1)) + log(1 + 2
             / (sqrt(1 - 3 * arg) - 1))) / sqrt(m_ov);
       }
       //       EQUATION 15.
       if (m_case == A2_2)
       {
-        const double arg = acos(1 - m_crit) / 3;
-        const double arg1 = cos(arg) / 3;
-        const double arg2 = sin(arg) / M_SQRT3;
-        const double y1 = -1. / 3. + arg1 + arg2;
-        const double y2 = -1. / 3. - 2 * arg1;
-        const double arg3 = y1 - y2;
-        const double y3 = y1 - 2 * arg2;
-        const double phi = asin(sqrt(arg3 / (y1 - m_om * (1 + z) / m_ok)));
-        const double k = sqrt((y1 - y3) / arg3);
-        const double n = -y1 / arg3;
-        const double arg4 = y1 * abs(m_ok) * sqrt(-arg3 * m_ok);
-        return 2 * m_om / arg4 * (ellint_3(k, n, phi) - ellint_1(k, phi));
+        const double arg3 = m_y1 - m_y2;
+        const double phi = asin(sqrt(arg3 / (m_y1 - m_om * (1 + z) / m_ok)));
+        const double k = m_k;
+        const double n = -m_y1 / arg3;
+        const double arg4 = m_y1 * abs(m_ok) * sqrt(-arg3 * m_ok);
+        return 2 * m_om / arg4 * (ellint_third(k, n, phi) - ellint_first(k,
+            phi));
       }
       return -1.0;
     }
@@ -249,27 +341,7 @@ namespace milia
     double flrw_nat::tb(double z) const
     {
       // om + ov = 1
-      return (2. / (3. * sqrt(1 - m_om))) * asinh(sqrt((1. / m_om - 1)
-          / (pow<3> (1 + z))));
-    }
-    double flrw_nat::ti(double z) const
-    {
-      gsl_error_handler_t* oldhandler = gsl_set_error_handler_off();
-      gsl_integration_workspace* w = gsl_integration_workspace_alloc(1000);
-      double result, error;
-      gsl_function F;
-      F.function = &helper_fun_time;
-      F.params = static_cast<void*> (const_cast<flrw_nat*> (this));
-      const int status = gsl_integration_qagiu(&F, z, 0, 1e-7, 1000, w,
-          &result, &error);
-      gsl_integration_workspace_free(w);
-      gsl_set_error_handler(oldhandler);
-      if (status)
-      {
-        throw std::runtime_error(std::string("gsl error: ")
-            + gsl_strerror(status));
-      }
-      return result;
+      return closed_form::flat_age(m_om, z);
     }
 
 } // namespace milia
@@ -22,15 +22,19 @@
 #include <config.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
-#include <boost/math/special_functions/ellint_1.hpp>
-#include <boost/math/special_functions/cbrt.hpp>
 #include <boost/math/special_functions/pow.hpp>
 
+#include "closed_form.h"
+#include "ellint.h"
 #include "flrw_nat.h"
+#include "probes.h"
+#include "stats_hooks.h"
 #include "util.h"
+#include "vmath.h"
 
 using std::sqrt;
 using std::abs;
@@ -40,82 +44,129 @@ using std::acos;
 using std::atan;
 using std::log;
 
-using boost::math::ellint_1;
-using boost::math::cbrt;
 using boost::math::asinh;
 using boost::math::atanh;
 using boost::math::pow;
 
-namespace
-{
-  const double M_SQRT3 = sqrt(3);
-  const double M_4THRT3 = sqrt(M_SQRT3);
-}
-
 namespace milia
 {
     // Luminosity distance
     double flrw_nat::dl(double z) const
     {
+      const detail::dl_probe probe(z, stats_case());
+      const stats::detail::kernel_scope scope(stats_case(),
+          stats::KERNEL_DL, 1);
       switch (m_case)
       {
         case OM_OV_0:
-          return 0.5 * z * (z + 2);
+          return closed_form::empty_dl(z);
         case OV_1:
         case OV_2:
         case OV_EDS:
-          return 2 * ((2 - m_om * (1 - z) - (2 - m_om) * sqrt(1 + m_om * z)))
-              / pow<2> (m_om);
+          return closed_form::matter_dl(m_om, z);
         case OM:
-          return ((1 + z) / m_ov) * (1 + z - sqrt(m_ov + (1 - m_ov)
-              * pow<2> (1 + z)));
+          return closed_form::vacuum_dl(m_ov, z);
         case OM_DS:
-          return z * (1 + z);
+          return closed_form::de_sitter_dl(z);
         case A1:
           //om+ol != 1 b < 0 || b > 2
         {
-          const double v = cbrt(m_kap * (m_crit - 1) + sqrt(m_crit * (m_crit - 2)));
-          const double y = (-1 + m_kap * (v + 1. / v)) / 3.;
-          const double A = sqrt(y * (3 * y + 2));
-          const double g = 1. / sqrt(A);
-          const double k = sqrt(0.5 + 0.25 * pow<2> (g) * (v + 1. / v));
-          const double sup = m_om / abs(m_ok);
-          const double phi = acos(((1 + z) * sup + m_kap * y - A) / ((1 + z)
-              * sup + m_kap * y + A));
-          const double phi0 = acos((sup + m_kap * y - A)
-              / (sup + m_kap * y + A));
-          return (1 + z) / m_sqok * sinc(m_kap, 1.0, g * (ellint_1(k,
-              phi0) - ellint_1(k, phi)));
+          const double phi = acos(((1 + z) * m_sup + m_kap * m_y1 - m_A)
+              / ((1 + z) * m_sup + m_kap * m_y1 + m_A));
+          return (1 + z) / m_sqok * sinc(m_kap, 1.0, m_g * (m_ellint0
+              - ellint_first(m_k, phi)));
         }
         case A2_1: // b=2
         case A2_2: // 0 < b < 2
         {
-          const double arg0 = acos(1 - m_crit) / 3.;
-          const double arg1 = m_om / abs(m_ok);
-          const double y1 = (-1. + cos(arg0) + M_SQRT3 * sin(arg0)) / 3.;
-          const double y2 = (-1. - 2. * cos(arg0)) / 3.;
-          const double y3 = (-1. + cos(arg0) - M_SQRT3 * sin(arg0)) / 3.;
-          const double g = 2. / sqrt(y1 - y2);
-          const double k = sqrt((y1 - y3) / (y1 - y2));
-          const double phi = asin(sqrt((y1 - y2) / ((1 + z) * arg1 + y1)));
-          const double phi0 = asin(sqrt((y1 - y2) / (arg1 + y1)));
-          return (1. + z) / m_sqok * sin(g * (ellint_1(k, phi0) - ellint_1(k,
-              phi)));
+          const double phi = asin(sqrt((m_y1 - m_y2) / ((1 + z) * m_sup
+              + m_y1)));
+          return (1. + z) / m_sqok * sin(m_g * (m_ellint0 - ellint_first(
+              m_k, phi)));
         }
         case OM_OV_1:
         {
           // om + ol = 1
-          const double k = sqrt(0.5 + 0.25 * M_SQRT3);
-          const double c1 = M_4THRT3;
-          const double arg0 = cbrt((1 / m_om - 1));
-          const double down = 1 + (1 + M_SQRT3) * arg0;
-          const double up = 1 + (1 - M_SQRT3) * arg0;
-          const double phi = acos((z + up) / (z + down));
-          const double phi0 = acos(up / down);
-          return (1 + z) / (c1 * sqrt(m_om) * sqrt(arg0)) * (ellint_1(k, phi0)
-              - ellint_1(k, phi));
+          const double phi = acos((z + m_up) / (z + m_down));
+          return (1 + z) * m_g * (m_ellint0 - ellint_first(m_k, phi));
         }
       }
       return -1;
     }
+
+    // Luminosity distance, array version
+    // The case is selected only once
+    // The elliptic cases use the kernels in ellint.h, the value at z = 0
+    // is recomputed with them so that the difference cancels at low z
+    void flrw_nat::dl(const double* z, double* res, std::size_t n) const
+    {
+      const detail::dl_array_probe probe(n, stats_case());
+      const stats::detail::kernel_scope scope(stats_case(),
+          stats::KERNEL_DL, n);
+      switch (m_case)
+      {
+        case OM_OV_0:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 0.5 * z[i] * (z[i] + 2);
+          break;
+        case OV_1:
+        case OV_2:
+        case OV_EDS:
+        {
+          // local copy, the loop does not vectorize with the member
+          const double om = m_om;
+          const double om2 = pow<2> (om);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 2 * ((2 - om * (1 - z[i]) - (2 - om) * sqrt(1 + om
+                * z[i]))) / om2;
+          break;
+        }
+        case OM:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = ((1 + z[i]) / m_ov) * (1 + z[i] - sqrt(m_ov + (1 - m_ov)
+                * pow<2> (1 + z[i])));
+          break;
+        case OM_DS:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = z[i] * (1 + z[i]);
+          break;
+        case A1:
+        {
+          // res holds the amplitudes first, F is computed in place
+          const double ellint0 = ellint_f(m_k, m_phi0, m_tol.ellint);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = vmath::acos(((1 + z[i]) * m_sup + m_kap * m_y1 - m_A)
+                / ((1 + z[i]) * m_sup + m_kap * m_y1 + m_A));
+          ellint_f(m_k, res, res, n, m_tol.ellint);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = (1 + z[i]) / m_sqok * sinc(m_kap, 1.0, m_g * (ellint0
+                - res[i]));
+          break;
+        }
+        case A2_1:
+        case A2_2:
+        {
+          const double ellint0 = ellint_f(m_k, m_phi0, m_tol.ellint);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = vmath::asin(sqrt((m_y1 - m_y2) / ((1 + z[i]) * m_sup
+                + m_y1)));
+          ellint_f(m_k, res, res, n, m_tol.ellint);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = (1. + z[i]) / m_sqok * sin(m_g * (ellint0 - res[i]));
+          break;
+        }
+        case OM_OV_1:
+        {
+          const double ellint0 = ellint_f(m_k, m_phi0, m_tol.ellint);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = vmath::acos((z[i] + m_up) / (z[i] + m_down));
+          ellint_f(m_k, res, res, n, m_tol.ellint);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = (1 + z[i]) * m_g * (ellint0 - res[i]);
+          break;
+        }
+        default:
+          std::fill(res, res + n, -1.);
+      }
+    }
 } // namespace milia
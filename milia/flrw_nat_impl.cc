@@ -35,9 +35,7 @@
 #include "metric.h"
 #include "util.h"
 
-#include "flrw_nat_impl.h"
-#include "flatmodel.h"
-#include "nonflatmodel.h"
+#include "flrw_nat_model.h"
 
 using std::abs;
 
@@ -46,7 +44,8 @@ namespace milia
 
  namespace impl {
 
-    flrw_nat_impl* flrw_nat_impl::construct(double matter, double vacuum)
+    flrw_nat_model::model_case flrw_nat_model::select(double matter,
+        double vacuum)
     {
       if (matter < 0 ) {
         throw std::domain_error("matter < 0 not allowed");
@@ -57,50 +56,76 @@ namespace milia
       }
 
       if (matter + vacuum == 1) {
-        if (matter == 0) {
-           return new flrw_nat_OM_DS();
-        }
-        else if (matter == 1) {
-            return new flrw_nat_OV_EDS();
-        }
-        else {
-            return new flrw_nat_OM_OV_1(matter);
-        }
+        if (matter == 0)
+          return OM_DS;
+        else if (matter == 1)
+          return OV_EDS;
+        else
+          return OM_OV_1;
       }
       else {
         if (vacuum == 0) {
-          if (matter == 0) {
-            return new flrw_nat_OM_OV_0();
-          }
-          if (matter < 1) {
-            return new flrw_nat_OV_1(matter);
-          }
-          if (matter > 1) {
-            return new flrw_nat_OV_2(matter);
-          }
+          if (matter == 0)
+            return OM_OV_0;
+          if (matter < 1)
+            return OV_1;
+          if (matter > 1)
+            return OV_2;
         }
         if (matter == 0) {
-          if (vacuum < 1) {
-          return new flrw_nat_OM(vacuum);
+          if (vacuum < 1)
+            return OM;
         }
-       }
       }
 
       double crit = -13.5 * pow<2> (matter) * vacuum / (pow<3> (1 - matter - vacuum));
 
-      if (crit == 2) {
-        return new flrw_nat_A2_1(matter, vacuum);
-      }
-      
-      if (crit < 0 || crit > 2) {
-        return new flrw_nat_A1(matter, vacuum);
-      }
+      if (crit == 2)
+        return A2_1;
 
-      if (crit > 0 && crit < 2) {
-        return new flrw_nat_A2_2(matter, vacuum);
-      }
+      if (crit < 0 || crit > 2)
+        return A1;
+
+      if (crit > 0 && crit < 2)
+        return A2_2;
+
+      return OV_EDS;
+    }
 
-      return new flrw_nat_OV_EDS();
+    flrw_nat_model::flrw_nat_model(double matter, double vacuum)
+    {
+      switch (select(matter, vacuum)) {
+        case OM_OV_0:
+          set(OM_OV_0, flrw_nat_OM_OV_0());
+          break;
+        case OV_1:
+          set(OV_1, flrw_nat_OV_1(matter));
+          break;
+        case OV_2:
+          set(OV_2, flrw_nat_OV_2(matter));
+          break;
+        case OV_EDS:
+          set(OV_EDS, flrw_nat_OV_EDS());
+          break;
+        case OM:
+          set(OM, flrw_nat_OM(vacuum));
+          break;
+        case OM_DS:
+          set(OM_DS, flrw_nat_OM_DS());
+          break;
+        case OM_OV_1:
+          set(OM_OV_1, flrw_nat_OM_OV_1(matter));
+          break;
+        case A1:
+          set(A1, flrw_nat_A1(matter, vacuum));
+          break;
+        case A2_1:
+          set(A2_1, flrw_nat_A2_1(matter, vacuum));
+          break;
+        case A2_2:
+          set(A2_2, flrw_nat_A2_2(matter, vacuum));
+          break;
+      }
     }
 
  } //namespace impl
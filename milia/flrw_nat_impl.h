@@ -22,6 +22,9 @@
 #define MILIA_FLRW_NAT_IMPL_H
 
 #include <cmath>
+#include <cstddef>
+
+#include "quantities.h"
 
 using std::abs;
 
@@ -29,68 +32,147 @@ namespace milia
 {
   namespace impl
   {
-    class flrw_nat_impl
+    // Parameters common to all the models
+    // The models are classes without virtual methods, they are held
+    // by value in impl::flrw_nat_model and called through a switch
+    // T is the floating point type of the computations
+    template<class T>
+    class basic_flrw_nat_impl
     {
       public:
-        flrw_nat_impl(double matter, double vacuum) : 
+        typedef T value_type;
+
+        basic_flrw_nat_impl(T matter, T vacuum) :
           m_om(matter), 
           m_ov(vacuum), 
           m_ok(1 - m_om - m_ov), 
-          m_sqok(sqrt(abs(m_ok)))
+          m_sqok(0)
         {
+          using std::sqrt;
+          using std::abs;
+          m_sqok = sqrt(abs(m_ok));
           m_kap = m_ok > 0 ? -1 : 1;
         }
 
-        static flrw_nat_impl* construct(double matter, double vacuum);
-
-        virtual double dc(double z) const = 0;
-
-        double get_matter() const
+        T get_matter() const
         {
           return m_om;
         }
 
-        double get_vacuum() const
-        {
-          return m_om;
-        }
-        double dm(double z) const 
+        T get_vacuum() const
         {
-          return dl(z) / (1 + z);
+          return m_ov;
         }
-        
-        double da(double z) const 
-        {
-          return dl(z) / ((1 + z) * (1 + z));
-        }
-
-        virtual const char* model() const = 0;
-
-        virtual double dl(double z) const = 0;
 
-        virtual double vol(double z) const = 0;
-        // double age() const = 0;
-        virtual double age(double z) const = 0;
-        //double lt(double z) const = 0;
       protected:
         // Matter density
-        double m_om;
+        T m_om;
 
         // Vacuum energy density
-        double m_ov;
+        T m_ov;
 
         // Critical parameter
         //double m_crit;
 
         // Curvature parameter
         // m_om + m_ov + m_ok = 1
-        double m_ok;
+        T m_ok;
         // Square root of abs(m_ok)
-        double m_sqok;
+        T m_sqok;
         // Negative of the sign of the curvature parameter
         short m_kap;
     };
 
+    typedef basic_flrw_nat_impl<double> flrw_nat_impl;
+
+    // Quantities derived from the methods of each model
+    // (dl, age, dc_from_dm, vol_from_dm)
+
+    // Array version of dl, overloaded by the models with a faster one
+    template<class Model>
+    void dl(const Model& m, const typename Model::value_type* z,
+        typename Model::value_type* res, std::size_t n)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = m.dl(z[i]);
+    }
+
+    template<class Model>
+    typename Model::value_type dm(const Model& m,
+        typename Model::value_type z)
+    {
+      return m.dl(z) / (1 + z);
+    }
+
+    template<class Model>
+    typename Model::value_type dc(const Model& m,
+        typename Model::value_type z)
+    {
+      return m.dc_from_dm(dm(m, z));
+    }
+
+    template<class Model>
+    typename Model::value_type vol(const Model& m,
+        typename Model::value_type z)
+    {
+      return m.vol_from_dm(dm(m, z));
+    }
+
+    template<class Model>
+    typename Model::value_type da(const Model& m,
+        typename Model::value_type z)
+    {
+      return m.dl(z) / ((1 + z) * (1 + z));
+    }
+
+    // Look-back time from the age at z, overloaded by
+    // the models without a finite age
+    template<class Model>
+    typename Model::value_type lt_from_age(const Model& m,
+        typename Model::value_type, typename Model::value_type t)
+    {
+      return m.age(0) - t;
+    }
+
+    template<class Model>
+    typename Model::value_type lt(const Model& m,
+        typename Model::value_type z)
+    {
+      return lt_from_age(m, z, m.age(z));
+    }
+
+    // Several quantities from a single dl and a single age
+    // computed in the type of the model, stored as double
+    template<class Model>
+    void eval(const Model& model, typename Model::value_type z,
+        unsigned mask, quantity_values& res)
+    {
+      typedef typename Model::value_type T;
+      if (mask & (Q_DL | Q_DA | Q_DM | Q_DC | Q_VOL))
+      {
+        const T l = model.dl(z);
+        const T m = l / (1 + z);
+        if (mask & Q_DL)
+          res.dl = l;
+        if (mask & Q_DA)
+          res.da = m / (1 + z);
+        if (mask & Q_DM)
+          res.dm = m;
+        if (mask & Q_DC)
+          res.dc = model.dc_from_dm(m);
+        if (mask & Q_VOL)
+          res.vol = model.vol_from_dm(m);
+      }
+      if (mask & (Q_AGE | Q_LT))
+      {
+        const T t = model.age(z);
+        if (mask & Q_AGE)
+          res.age = t;
+        if (mask & Q_LT)
+          res.lt = lt_from_age(model, z, t);
+      }
+    }
+
   } // namespace impl
 
 } // namespace milia
@@ -0,0 +1,693 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <boost/math/constants/constants.hpp>
+#include <boost/math/special_functions/cbrt.hpp>
+#include <boost/math/special_functions/expm1.hpp>
+#include <boost/math/special_functions/log1p.hpp>
+#include <boost/math/special_functions/pow.hpp>
+
+#include "flrw_nat.h"
+#include "flrw_prec.h"
+#include "util.h"
+
+using std::sqrt;
+using std::abs;
+using std::sinh;
+using std::sin;
+using std::cos;
+using std::acos;
+using std::asin;
+using std::pow;
+
+using boost::math::cbrt;
+using boost::math::expm1;
+using boost::math::log1p;
+
+namespace
+{
+  const char* NO_REDSHIFT = "No redshift with this value";
+  const double HALF_PI = boost::math::constants::half_pi<double>();
+
+  void check_positive(const double* x, std::size_t n, const char* msg)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      if (!(x[i] >= 0))
+        throw std::domain_error(msg);
+  }
+}
+
+namespace milia
+{
+    double flrw_nat::z_from_dl(double dl) const
+    {
+      if (!(dl >= 0))
+        throw std::domain_error("Distance < 0 not allowed");
+
+      switch (m_case)
+      {
+        case OM_OV_0:
+          return 2 * dl / (1 + sqrt(1 + 2 * dl));
+        case OM_DS:
+          return 2 * dl / (1 + sqrt(1 + 4 * dl));
+        case OV_EDS:
+        {
+          // dl = 2 s (s - 1), with s = sqrt(1 + z)
+          const double s1 = dl / (1 + sqrt(1 + 2 * dl));
+          return s1 * (s1 + 2);
+        }
+        default:
+          return z_solve(Q_DL, dl);
+      }
+    }
+
+    double flrw_nat::z_from_dc(double dc) const
+    {
+      if (!(dc >= 0))
+        throw std::domain_error("Distance < 0 not allowed");
+
+      switch (m_case)
+      {
+        case OM_OV_0:
+          return expm1(dc);
+        case OM_DS:
+          return dc;
+        case OV_EDS:
+        {
+          // dc = 2 (1 - 1 / s), with s = sqrt(1 + z)
+          if (dc >= 2)
+            throw std::domain_error(NO_REDSHIFT);
+          const double s1 = dc / (2 - dc);
+          return s1 * (s1 + 2);
+        }
+        default:
+          return z_solve(Q_DC, dc);
+      }
+    }
+
+    double flrw_nat::z_from_dm(double dm) const
+    {
+      if (!(dm >= 0))
+        throw std::domain_error("Distance < 0 not allowed");
+
+      switch (m_case)
+      {
+        // Flat cases
+        case OV_EDS: // EdS
+        case OM_DS: // dS
+        case OM_OV_1: // Flat
+          return z_from_dc(dm);
+        default:
+          if (m_kap == 1 && m_sqok * dm > 1)
+            throw std::domain_error(NO_REDSHIFT);
+          return z_from_dc(asinc(m_kap, m_sqok, dm));
+      }
+    }
+
+    double flrw_nat::z_from_vol(double vol) const
+    {
+      if (!(vol >= 0))
+        throw std::domain_error("Volume < 0 not allowed");
+
+      switch (m_case)
+      {
+        // Flat cases
+        case OV_EDS: // EdS
+        case OM_DS: // dS
+        case OM_OV_1: // Flat
+          return z_from_dc(cbrt(3 * vol));
+        default:
+          return z_solve(Q_VOL, vol);
+      }
+    }
+
+    double flrw_nat::z_from_age(double age) const
+    {
+      if (m_case == OM_DS)
+        throw std::domain_error("The age of the de Sitter Universe is infinite");
+      if (!(age > 0) || age > uage())
+        throw std::domain_error(NO_REDSHIFT);
+
+      switch (m_case)
+      {
+        case OM_OV_0:
+          return 1 / age - 1;
+        case OV_EDS:
+          return pow(2 / (3 * age), 2. / 3.) - 1;
+        case OM:
+          return 1 / (sqrt(1 / m_ov - 1) * sinh(age * sqrt(m_ov))) - 1;
+        case OM_OV_1:
+          return cbrt((1 / m_om - 1) / boost::math::pow<2> (sinh(1.5 * sqrt(1
+              - m_om) * age))) - 1;
+        default:
+          return z_solve(Q_AGE, -age);
+      }
+    }
+
+    double flrw_nat::z_from_lt(double lt) const
+    {
+      if (!(lt >= 0))
+        throw std::domain_error("Look-back time < 0 not allowed");
+
+      switch (m_case)
+      {
+        case OM_DS:
+          return expm1(lt);
+        case OM_OV_0:
+          if (lt >= 1)
+            throw std::domain_error(NO_REDSHIFT);
+          return lt / (1 - lt);
+        default:
+          if (lt >= uage())
+            throw std::domain_error(NO_REDSHIFT);
+          return z_solve(Q_LT, lt);
+      }
+    }
+
+    void flrw_nat::z_from_dl(const double* dl, double* res, std::size_t n) const
+    {
+      check_positive(dl, n, "Distance < 0 not allowed");
+
+      switch (m_case)
+      {
+        case OM_OV_0:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 2 * dl[i] / (1 + sqrt(1 + 2 * dl[i]));
+          break;
+        case OM_DS:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 2 * dl[i] / (1 + sqrt(1 + 4 * dl[i]));
+          break;
+        case OV_EDS:
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            const double s1 = dl[i] / (1 + sqrt(1 + 2 * dl[i]));
+            res[i] = s1 * (s1 + 2);
+          }
+          break;
+        default:
+          z_solve(Q_DL, dl, res, n);
+      }
+    }
+
+    void flrw_nat::z_from_dc(const double* dc, double* res, std::size_t n) const
+    {
+      check_positive(dc, n, "Distance < 0 not allowed");
+
+      switch (m_case)
+      {
+        case OM_OV_0:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = expm1(dc[i]);
+          break;
+        case OM_DS:
+          std::copy(dc, dc + n, res);
+          break;
+        case OV_EDS:
+          if (n > 0 && *std::max_element(dc, dc + n) >= 2)
+            throw std::domain_error(NO_REDSHIFT);
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            const double s1 = dc[i] / (2 - dc[i]);
+            res[i] = s1 * (s1 + 2);
+          }
+          break;
+        default:
+          z_solve(Q_DC, dc, res, n);
+      }
+    }
+
+    void flrw_nat::z_from_dm(const double* dm, double* res, std::size_t n) const
+    {
+      check_positive(dm, n, "Distance < 0 not allowed");
+
+      switch (m_case)
+      {
+        // Flat cases
+        case OV_EDS: // EdS
+        case OM_DS: // dS
+        case OM_OV_1: // Flat
+          z_from_dc(dm, res, n);
+          break;
+        default:
+          if (m_kap == 1 && n > 0 && m_sqok * *std::max_element(dm, dm + n) > 1)
+            throw std::domain_error(NO_REDSHIFT);
+          // the inverses accept res == input
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = asinc(m_kap, m_sqok, dm[i]);
+          z_from_dc(res, res, n);
+      }
+    }
+
+    void flrw_nat::z_from_vol(const double* vol, double* res, std::size_t n) const
+    {
+      check_positive(vol, n, "Volume < 0 not allowed");
+
+      switch (m_case)
+      {
+        // Flat cases
+        case OV_EDS: // EdS
+        case OM_DS: // dS
+        case OM_OV_1: // Flat
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = cbrt(3 * vol[i]);
+          z_from_dc(res, res, n);
+          break;
+        default:
+          z_solve(Q_VOL, vol, res, n);
+      }
+    }
+
+    void flrw_nat::z_from_age(const double* age, double* res, std::size_t n) const
+    {
+      if (m_case == OM_DS)
+        throw std::domain_error("The age of the de Sitter Universe is infinite");
+      const double ua = uage();
+      for (std::size_t i = 0; i < n; ++i)
+        if (!(age[i] > 0) || age[i] > ua)
+          throw std::domain_error(NO_REDSHIFT);
+
+      switch (m_case)
+      {
+        case OM_OV_0:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 1 / age[i] - 1;
+          break;
+        case OV_EDS:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = pow(2 / (3 * age[i]), 2. / 3.) - 1;
+          break;
+        case OM:
+        {
+          const double pre = sqrt(1 / m_ov - 1);
+          const double sq = sqrt(m_ov);
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = 1 / (pre * sinh(age[i] * sq)) - 1;
+          break;
+        }
+        case OM_OV_1:
+        {
+          const double pre = 1.5 * sqrt(1 - m_om);
+          const double arg = 1 / m_om - 1;
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = cbrt(arg / boost::math::pow<2> (sinh(pre * age[i]))) - 1;
+          break;
+        }
+        default:
+          // minus the age is increasing with z
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = -age[i];
+          z_solve(Q_AGE, res, res, n);
+      }
+    }
+
+    void flrw_nat::z_from_lt(const double* lt, double* res, std::size_t n) const
+    {
+      check_positive(lt, n, "Look-back time < 0 not allowed");
+
+      switch (m_case)
+      {
+        case OM_DS:
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = expm1(lt[i]);
+          break;
+        case OM_OV_0:
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            if (lt[i] >= 1)
+              throw std::domain_error(NO_REDSHIFT);
+            res[i] = lt[i] / (1 - lt[i]);
+          }
+          break;
+        default:
+          if (n > 0 && *std::max_element(lt, lt + n) >= uage())
+            throw std::domain_error(NO_REDSHIFT);
+          z_solve(Q_LT, lt, res, n);
+      }
+    }
+
+    double flrw_nat::z_forward(quantity q, double z, double& deriv) const
+    {
+      const double e = get_hubble(z);
+      switch (q)
+      {
+        case Q_DL:
+        {
+          const double l = dl(z);
+          const double m = dm(z, l);
+          // d dm / d dc = sqrt(1 + ok dm^2) in all the geometries,
+          // negative past the maximum of dm in the closed models
+          double c = sqrt(1 + m_ok * m * m);
+          if (log1p(z) > u_increasing(Q_DM))
+            c = -c;
+          deriv = (1 + z) * (m + (1 + z) * c / e);
+          return l;
+        }
+        case Q_DC:
+          deriv = (1 + z) / e;
+          return dc(z);
+        case Q_VOL:
+        {
+          const double m = dm(z);
+          deriv = (1 + z) * m * m / e;
+          return vol(z, m);
+        }
+        case Q_LT:
+          deriv = 1 / e;
+          return lt(z);
+        case Q_AGE:
+          deriv = 1 / e;
+          return -age(z);
+        default:
+          deriv = 0;
+          return 0;
+      }
+    }
+
+    void flrw_nat::z_forward(quantity q, const double* z, double* f,
+        double* deriv, std::size_t n) const
+    {
+      // local copies, the loops do not vectorize with members
+      const double om = m_om;
+      const double ok = m_ok;
+      const double ov = m_ov;
+      // deriv holds E(z) first
+      for (std::size_t i = 0; i < n; ++i)
+        deriv[i] = sqrt(om * boost::math::pow<3> (1 + z[i]) + ok
+            * boost::math::pow<2> (1 + z[i]) + ov);
+      switch (q)
+      {
+        case Q_DL:
+        {
+          const double udm = u_increasing(Q_DM);
+          dl(z, f, n);
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            const double m = f[i] / (1 + z[i]);
+            double c = sqrt(1 + ok * m * m);
+            if (log1p(z[i]) > udm)
+              c = -c;
+            deriv[i] = (1 + z[i]) * (m + (1 + z[i]) * c / deriv[i]);
+          }
+          break;
+        }
+        case Q_DC:
+          dc(z, f, n);
+          for (std::size_t i = 0; i < n; ++i)
+            deriv[i] = (1 + z[i]) / deriv[i];
+          break;
+        case Q_VOL:
+          dm(z, f, n);
+          for (std::size_t i = 0; i < n; ++i)
+            deriv[i] = (1 + z[i]) * f[i] * f[i] / deriv[i];
+          vol_from_dm(f, f, n);
+          break;
+        case Q_LT:
+          lt(z, f, n);
+          for (std::size_t i = 0; i < n; ++i)
+            deriv[i] = 1 / deriv[i];
+          break;
+        case Q_AGE:
+          age(z, f, n);
+          for (std::size_t i = 0; i < n; ++i)
+          {
+            f[i] = -f[i];
+            deriv[i] = 1 / deriv[i];
+          }
+          break;
+        default:
+          std::fill(f, f + n, 0.);
+          std::fill(deriv, deriv + n, 0.);
+      }
+    }
+
+    double flrw_nat::chi(double z) const
+    {
+      switch (m_case)
+      {
+        case OV_2:
+          // conformal time of the closed matter model
+          return acos(2 / m_om - 1) - acos(1 - 2 * (m_om - 1) / (m_om * (1
+              + z)));
+        case A1:
+        {
+          const double phi = acos(((1 + z) * m_sup + m_kap * m_y1 - m_A)
+              / ((1 + z) * m_sup + m_kap * m_y1 + m_A));
+          return m_g * (m_ellint0 - ellint_first(m_k, phi));
+        }
+        case A2_1:
+        case A2_2:
+        {
+          const double phi = asin(sqrt((m_y1 - m_y2) / ((1 + z) * m_sup
+              + m_y1)));
+          return m_g * (m_ellint0 - ellint_first(m_k, phi));
+        }
+        default:
+          return 0;
+      }
+    }
+
+    // dm, and dc and vol computed from it, have a maximum at chi = pi / 2,
+    // dl at a point between pi / 2 and pi. The points are found by
+    // bisection in u, chi is increasing
+    double flrw_nat::u_increasing(quantity q) const
+    {
+      if (q == Q_AGE || q == Q_LT || m_kap != 1)
+        return FLRW_INV_UMAX;
+      switch (m_case)
+      {
+        case OV_2:
+        case A1:
+        case A2_1:
+        case A2_2:
+          break;
+        default:
+          return FLRW_INV_UMAX;
+      }
+
+      const detail::lazy_double& cache = q == Q_DL ? m_udl : m_udm;
+      double res;
+      if (cache.get(res))
+        return res;
+
+      const double chi_max = chi(expm1(FLRW_INV_UMAX));
+      res = FLRW_INV_UMAX;
+      if (chi_max > HALF_PI)
+      {
+        double lo = 0;
+        double hi = FLRW_INV_UMAX;
+        while (hi - lo > m_tol.inverse * hi)
+        {
+          const double mid = 0.5 * (lo + hi);
+          (chi(expm1(mid)) < HALF_PI ? lo : hi) = mid;
+        }
+        res = lo;
+      }
+      if (q == Q_DL && res < FLRW_INV_UMAX)
+      {
+        // sign of d dl / du, (1 + z) (sin(chi) / sqok + (1 + z)
+        // cos(chi) / E), positive at chi = pi / 2 and negative at pi
+        double lo = res;
+        double hi = FLRW_INV_UMAX;
+        const double zh = expm1(hi);
+        const double ch = chi(zh);
+        if (sin(ch) / m_sqok + (1 + zh) * cos(ch) / get_hubble(zh) > 0)
+          res = hi;
+        else
+        {
+          while (hi - lo > m_tol.inverse * hi)
+          {
+            const double mid = 0.5 * (lo + hi);
+            const double z = expm1(mid);
+            const double c = chi(z);
+            (sin(c) / m_sqok + (1 + z) * cos(c) / get_hubble(z) > 0 ? lo
+                : hi) = mid;
+          }
+          res = lo;
+        }
+      }
+      cache.set(res);
+      return res;
+    }
+
+    // Newton's method in u = log(1 + z), the steps that leave the
+    // bracket [lo, hi] are replaced by bisection
+    // The upper end is only evaluated if the iterations need it. A
+    // value above f(hi) drives the steps out of the bracket, so it is
+    // caught there and not by the residual, which for lt and the age
+    // is the difference of two close values
+    double flrw_nat::z_solve(quantity q, double y) const
+    {
+      double d;
+      double lo = 0;
+      // f is increasing in [0, hi]
+      double hi = u_increasing(q);
+      bool bracketed = false;
+
+      // low z approximations of f
+      double u;
+      switch (q)
+      {
+        case Q_VOL:
+          u = log1p(cbrt(3 * y));
+          break;
+        case Q_AGE:
+          u = log1p(uage() + y);
+          break;
+        default:
+          u = log1p(y);
+      }
+      u = std::min(u, 0.5 * hi);
+
+      for (int i = 0; i < FLRW_INV_MAXITER; ++i)
+      {
+        const double g = z_forward(q, expm1(u), d) - y;
+        if (g < 0)
+          lo = u;
+        else
+        {
+          hi = u;
+          bracketed = true;
+        }
+        double un = d > 0 ? u - g / d : u;
+        if (!(d > 0 && un >= lo && un <= hi))
+        {
+          if (!bracketed)
+          {
+            if (z_forward(q, expm1(hi), d) < y)
+              throw std::domain_error(NO_REDSHIFT);
+            bracketed = true;
+          }
+          un = 0.5 * (lo + hi);
+        }
+        if (abs(un - u) <= m_tol.inverse * un)
+        {
+          if (!bracketed && z_forward(q, expm1(hi), d) < y)
+            throw std::domain_error(NO_REDSHIFT);
+          return expm1(un);
+        }
+        u = un;
+      }
+      return expm1(u);
+    }
+
+    // The table covers [0, umax] with umax the first power of 2 where
+    // f is above all the values, or the end of the range where f
+    // increases. u starts from the inverse cubic Hermite interpolation
+    // of the table, Newton's method is run over blocks
+    // res may be the same array as y
+    void flrw_nat::z_solve(quantity q, const double* y, double* res,
+        std::size_t n) const
+    {
+      if (n == 0)
+        return;
+
+      double d;
+      const double ymax = *std::max_element(y, y + n);
+      const double uinc = u_increasing(q);
+      double umax = std::min(1., uinc);
+      while (z_forward(q, expm1(umax), d) < ymax)
+      {
+        if (umax >= uinc)
+          throw std::domain_error(NO_REDSHIFT);
+        umax = std::min(2 * umax, uinc);
+      }
+
+      const std::size_t nt = FLRW_INV_NODES;
+      double ut[FLRW_INV_NODES], zt[FLRW_INV_NODES];
+      double ft[FLRW_INV_NODES], dt[FLRW_INV_NODES];
+      for (std::size_t j = 0; j < nt; ++j)
+      {
+        ut[j] = umax * j / (nt - 1);
+        zt[j] = expm1(ut[j]);
+      }
+      z_forward(q, zt, ft, dt, nt);
+
+      // the values go through the scalar version if the table
+      // is not increasing
+      for (std::size_t j = 1; j < nt; ++j)
+        if (!(ft[j] > ft[j - 1]))
+        {
+          for (std::size_t i = 0; i < n; ++i)
+            res[i] = z_solve(q, y[i]);
+          return;
+        }
+
+      for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+      {
+        const std::size_t w = std::min(FLRW_BLOCK, n - i);
+        const double* yb = y + i;
+        double u[FLRW_BLOCK], lo[FLRW_BLOCK], hi[FLRW_BLOCK];
+        double z[FLRW_BLOCK], f[FLRW_BLOCK], fd[FLRW_BLOCK];
+        for (std::size_t l = 0; l < w; ++l)
+        {
+          std::size_t j = std::upper_bound(ft, ft + nt, yb[l]) - ft;
+          j = std::min(std::max(j, std::size_t(1)), nt - 1);
+          const double h = ft[j] - ft[j - 1];
+          const double t = (yb[l] - ft[j - 1]) / h;
+          // slopes du/df scaled to the interval, linear if df/du = 0
+          const double du = ut[j] - ut[j - 1];
+          const double m0 = dt[j - 1] > 0 ? h / dt[j - 1] : du;
+          const double m1 = dt[j] > 0 ? h / dt[j] : du;
+          const double t2 = t * t;
+          const double t3 = t2 * t;
+          const double v = (2 * t3 - 3 * t2 + 1) * ut[j - 1] + (t3 - 2 * t2
+              + t) * m0 + (-2 * t3 + 3 * t2) * ut[j] + (t3 - t2) * m1;
+          lo[l] = ut[j - 1];
+          hi[l] = ut[j];
+          u[l] = std::min(std::max(v, lo[l]), hi[l]);
+        }
+        for (int it = 0; it < FLRW_INV_MAXITER; ++it)
+        {
+          for (std::size_t l = 0; l < w; ++l)
+            z[l] = expm1(u[l]);
+          z_forward(q, z, f, fd, w);
+          bool done = true;
+          for (std::size_t l = 0; l < w; ++l)
+          {
+            const double g = f[l] - yb[l];
+            if (g < 0)
+              lo[l] = u[l];
+            else
+              hi[l] = u[l];
+            double un = fd[l] > 0 ? u[l] - g / fd[l] : u[l];
+            if (!(un >= lo[l] && un <= hi[l]))
+              un = 0.5 * (lo[l] + hi[l]);
+            if (abs(un - u[l]) > m_tol.inverse * un)
+              done = false;
+            u[l] = un;
+          }
+          if (done)
+            break;
+        }
+        for (std::size_t l = 0; l < w; ++l)
+          res[i + l] = expm1(u[l]);
+      }
+    }
+
+} // namespace milia
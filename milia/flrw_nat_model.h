@@ -0,0 +1,251 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_FLRW_NAT_MODEL_H
+#define MILIA_FLRW_NAT_MODEL_H
+
+#include <new>
+
+#include "flrw_nat_impl.h"
+#include "flatmodel.h"
+#include "nonflatmodel.h"
+
+namespace milia
+{
+  namespace impl
+  {
+    // Larger of two sizes
+    template<std::size_t A, std::size_t B>
+    struct max_size
+    {
+        enum
+        {
+          value = A > B ? A : B
+        };
+    };
+
+    // One of the model classes, held by value
+    //
+    // A closed tagged union: the model is constructed in storage inside
+    // the object and the methods switch on the tag, the calls to the
+    // model are direct. The models only hold doubles, so the union is
+    // copied by the implicit copy constructor, without allocations.
+    class flrw_nat_model
+    {
+      public:
+        enum model_case
+        {
+          OM_OV_0, OV_1, OV_2, OV_EDS, OM, OM_DS, OM_OV_1, A1, A2_1, A2_2
+        };
+
+        // Selects the model
+        // @throws std::domain_error if a density is negative
+        flrw_nat_model(double matter, double vacuum);
+
+        // Case of the densities, without constructing the model
+        // @throws std::domain_error if a density is negative
+        static model_case select(double matter, double vacuum);
+
+        model_case get_case() const
+        {
+          return m_case;
+        }
+
+        // Calls v(model) with the model of the case
+        // Visitor has a typedef result_type and a template
+        // operator()(const Model&) const
+        template<class Visitor>
+        typename Visitor::result_type visit(const Visitor& v) const
+        {
+          switch (m_case)
+          {
+            case OM_OV_0:
+              return v(get<flrw_nat_OM_OV_0> ());
+            case OV_1:
+              return v(get<flrw_nat_OV_1> ());
+            case OV_2:
+              return v(get<flrw_nat_OV_2> ());
+            case OV_EDS:
+              return v(get<flrw_nat_OV_EDS> ());
+            case OM:
+              return v(get<flrw_nat_OM> ());
+            case OM_DS:
+              return v(get<flrw_nat_OM_DS> ());
+            case OM_OV_1:
+              return v(get<flrw_nat_OM_OV_1> ());
+            case A1:
+              return v(get<flrw_nat_A1> ());
+            case A2_1:
+              return v(get<flrw_nat_A2_1> ());
+            default:
+              return v(get<flrw_nat_A2_2> ());
+          }
+        }
+
+      private:
+        template<class Model>
+        const Model& get() const
+        {
+          return *reinterpret_cast<const Model*> (m_storage.bytes);
+        }
+
+        template<class Model>
+        void set(model_case c, const Model& model)
+        {
+          m_case = c;
+          new (m_storage.bytes) Model(model);
+        }
+
+        enum
+        {
+          STORAGE = max_size<max_size<max_size<sizeof(flrw_nat_OM_OV_0),
+              sizeof(flrw_nat_OV_1)>::value, max_size<sizeof(flrw_nat_OV_2),
+              sizeof(flrw_nat_OV_EDS)>::value>::value, max_size<max_size<
+              max_size<sizeof(flrw_nat_OM), sizeof(flrw_nat_OM_DS)>::value,
+              max_size<sizeof(flrw_nat_OM_OV_1), sizeof(flrw_nat_A1)>::value>::value,
+              max_size<sizeof(flrw_nat_A2_1), sizeof(flrw_nat_A2_2)>::value>::value>::value
+        };
+
+        model_case m_case;
+        // the double aligns the storage for the models
+        union
+        {
+            double align;
+            unsigned char bytes[STORAGE];
+        } m_storage;
+    };
+
+    // Visitors of flrw_nat_model
+
+    struct dl_visitor
+    {
+        typedef double result_type;
+        double z;
+        template<class Model>
+        double operator()(const Model& m) const
+        {
+          return m.dl(z);
+        }
+    };
+
+    struct dm_visitor
+    {
+        typedef double result_type;
+        double z;
+        template<class Model>
+        double operator()(const Model& m) const
+        {
+          return dm(m, z);
+        }
+    };
+
+    struct da_visitor
+    {
+        typedef double result_type;
+        double z;
+        template<class Model>
+        double operator()(const Model& m) const
+        {
+          return da(m, z);
+        }
+    };
+
+    struct dc_visitor
+    {
+        typedef double result_type;
+        double z;
+        template<class Model>
+        double operator()(const Model& m) const
+        {
+          return dc(m, z);
+        }
+    };
+
+    struct vol_visitor
+    {
+        typedef double result_type;
+        double z;
+        template<class Model>
+        double operator()(const Model& m) const
+        {
+          return vol(m, z);
+        }
+    };
+
+    struct age_visitor
+    {
+        typedef double result_type;
+        double z;
+        template<class Model>
+        double operator()(const Model& m) const
+        {
+          return m.age(z);
+        }
+    };
+
+    struct lt_visitor
+    {
+        typedef double result_type;
+        double z;
+        template<class Model>
+        double operator()(const Model& m) const
+        {
+          return lt(m, z);
+        }
+    };
+
+    struct eval_visitor
+    {
+        typedef void result_type;
+        double z;
+        unsigned mask;
+        quantity_values* res;
+        template<class Model>
+        void operator()(const Model& m) const
+        {
+          eval(m, z, mask, *res);
+        }
+    };
+
+    struct model_visitor
+    {
+        typedef const char* result_type;
+        template<class Model>
+        const char* operator()(const Model& m) const
+        {
+          return m.model();
+        }
+    };
+
+    struct parameters_visitor
+    {
+        typedef const flrw_nat_impl& result_type;
+        template<class Model>
+        const flrw_nat_impl& operator()(const Model& m) const
+        {
+          return m;
+        }
+    };
+
+  } // namespace impl
+
+} // namespace milia
+
+#endif /* MILIA_FLRW_NAT_MODEL_H */
@@ -21,6 +21,56 @@
 #ifndef MILIA_FLRW_PREC_H
 #define MILIA_FLRW_PREC_H
 
+#include <cstddef>
+
 const double FLRW_EQ_TOL = 1.0e-14;
 
+// sqrt(3) and its square root, in the roots of the cubic of A1 and OM
+const double FLRW_SQRT3 = 1.7320508075688772935;
+const double FLRW_4THRT3 = 1.3160740129524924608;
+
+// Age of case A1, equation 10 has a node where 1 - n sin^2(phi) = 0
+// Width of the band around the node where eq 10 loses digits
+const double FLRW_NODE_TOL = 1.0e-3;
+// Step in z, relative to 1 + z, to leave the band
+const double FLRW_NODE_STEP = 1.0e-2;
+
+// Relative tolerance of the numerical integration of the age
+const double FLRW_QUAD_TOL = 1.0e-12;
+
+// Size of the blocks of the array versions that need
+// temporary storage
+const std::size_t FLRW_BLOCK = 64;
+
+// Inverse functions, redshift from a distance, time or volume
+// Relative tolerance in log(1 + z)
+const double FLRW_INV_TOL = 1.0e-13;
+// Maximum number of iterations of Newton's method
+const int FLRW_INV_MAXITER = 100;
+// Upper limit of log(1 + z) in the search, z ~ 8e13
+const double FLRW_INV_UMAX = 32;
+// Number of nodes of the tables of the array versions
+const std::size_t FLRW_INV_NODES = 65;
+
+// Below this value of |ok dm^2|, the comoving volume is computed
+// with a series, the closed form cancels at low z. The truncation
+// error of the series is 0.03 |ok dm^2|^9
+const double FLRW_VOL_SERIES = 1.0e-2;
+
+// Accuracy policies, milia/accuracy.h
+// ACCURACY_REFERENCE uses the tolerances above and elliptic
+// integrals to full precision
+// The distances and the ages are differences of elliptic integrals.
+// At low z in the closed models with vacuum > 1 they lose up to three
+// digits, so the integrals are computed with a tolerance 1000 times
+// smaller
+// Relative tolerance of ACCURACY_FAST
+const double FLRW_FAST_TOL = 1.0e-6;
+const double FLRW_FAST_ELLINT = 1.0e-9;
+const double FLRW_FAST_VOL_SERIES = 0.25;
+// Relative tolerance of ACCURACY_STANDARD
+const double FLRW_STANDARD_TOL = 1.0e-10;
+const double FLRW_STANDARD_ELLINT = 1.0e-13;
+const double FLRW_STANDARD_VOL_SERIES = 0.1;
+
 #endif /* MILIA_FLRW_PREC_H */
@@ -0,0 +1,520 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_FLRW_T_H
+#define MILIA_FLRW_T_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include <milia/flrw_nat_model.h>
+#include <milia/quantities.h>
+
+namespace milia
+{
+  /**
+   * Computation cases of milia::flrw_t
+   *
+   * Each tag names the class of the model in milia/flatmodel.h or
+   * milia/nonflatmodel.h for a floating point type (basic<T>::type),
+   * its case and how it is constructed. The flat models (flat_lcdm,
+   * eds, de_sitter) are available in float, double and long double,
+   * the others only in double. flat_lcdm_approx is the approximate
+   * flat model, for bulk computations that accept a relative error
+   * of 1e-6.
+   */
+  namespace model
+  {
+    /// Flat, with matter and vacuum energy \f$ \Omega_m + \Omega_\Lambda = 1 \f$
+    struct flat_lcdm
+    {
+        template<class T>
+        struct basic
+        {
+            typedef impl::basic_flrw_nat_OM_OV_1<T> type;
+        };
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OM_OV_1;
+        template<class T>
+        static typename basic<T>::type make(double matter, double)
+        {
+          return typename basic<T>::type(T(matter));
+        }
+    };
+
+    /// As flat_lcdm, with polynomial fits instead of elliptic integrals
+    /// Faster, with a relative error below 1e-6 for
+    /// \f$ 0.05 \le \Omega_m \le 1 \f$ and \f$ 0 \le z \le 1100 \f$
+    struct flat_lcdm_approx
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OM_OV_1;
+        template<class T>
+        static typename basic<T>::type make(double matter, double)
+        {
+          return typename basic<T>::type(matter);
+        }
+    };
+
+    template<>
+    struct flat_lcdm_approx::basic<double>
+    {
+        typedef impl::flrw_nat_OM_OV_1_approx type;
+    };
+
+    /// Einstein-de Sitter \f$ \Omega_m = 1, \Omega_\Lambda = 0 \f$
+    struct eds
+    {
+        template<class T>
+        struct basic
+        {
+            typedef impl::basic_flrw_nat_OV_EDS<T> type;
+        };
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OV_EDS;
+        template<class T>
+        static typename basic<T>::type make(double, double)
+        {
+          return typename basic<T>::type();
+        }
+    };
+
+    /// de Sitter \f$ \Omega_m = 0, \Omega_\Lambda = 1 \f$
+    struct de_sitter
+    {
+        template<class T>
+        struct basic
+        {
+            typedef impl::basic_flrw_nat_OM_DS<T> type;
+        };
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OM_DS;
+        template<class T>
+        static typename basic<T>::type make(double, double)
+        {
+          return typename basic<T>::type();
+        }
+    };
+
+    /// Empty \f$ \Omega_m = 0, \Omega_\Lambda = 0 \f$
+    struct empty
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OM_OV_0;
+        template<class T>
+        static typename basic<T>::type make(double, double)
+        {
+          return typename basic<T>::type();
+        }
+    };
+
+    template<>
+    struct empty::basic<double>
+    {
+        typedef impl::flrw_nat_OM_OV_0 type;
+    };
+
+    /// Open, matter only \f$ 0 < \Omega_m < 1, \Omega_\Lambda = 0 \f$
+    struct open_matter
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OV_1;
+        template<class T>
+        static typename basic<T>::type make(double matter, double)
+        {
+          return typename basic<T>::type(matter);
+        }
+    };
+
+    template<>
+    struct open_matter::basic<double>
+    {
+        typedef impl::flrw_nat_OV_1 type;
+    };
+
+    /// Closed, matter only \f$ \Omega_m > 1, \Omega_\Lambda = 0 \f$
+    struct closed_matter
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OV_2;
+        template<class T>
+        static typename basic<T>::type make(double matter, double)
+        {
+          return typename basic<T>::type(matter);
+        }
+    };
+
+    template<>
+    struct closed_matter::basic<double>
+    {
+        typedef impl::flrw_nat_OV_2 type;
+    };
+
+    /// Vacuum energy only \f$ \Omega_m = 0, 0 < \Omega_\Lambda < 1 \f$
+    struct vacuum_only
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::OM;
+        template<class T>
+        static typename basic<T>::type make(double, double vacuum)
+        {
+          return typename basic<T>::type(vacuum);
+        }
+    };
+
+    template<>
+    struct vacuum_only::basic<double>
+    {
+        typedef impl::flrw_nat_OM type;
+    };
+
+    /// Non-flat, case A1 of the elliptic integrals
+    struct a1
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::A1;
+        template<class T>
+        static typename basic<T>::type make(double matter, double vacuum)
+        {
+          return typename basic<T>::type(matter, vacuum);
+        }
+    };
+
+    template<>
+    struct a1::basic<double>
+    {
+        typedef impl::flrw_nat_A1 type;
+    };
+
+    /// Non-flat, case A2 of the elliptic integrals with a double root
+    struct a2_1
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::A2_1;
+        template<class T>
+        static typename basic<T>::type make(double matter, double vacuum)
+        {
+          return typename basic<T>::type(matter, vacuum);
+        }
+    };
+
+    template<>
+    struct a2_1::basic<double>
+    {
+        typedef impl::flrw_nat_A2_1 type;
+    };
+
+    /// Non-flat, case A2 of the elliptic integrals
+    struct a2_2
+    {
+        template<class T>
+        struct basic;
+        static const impl::flrw_nat_model::model_case id =
+            impl::flrw_nat_model::A2_2;
+        template<class T>
+        static typename basic<T>::type make(double matter, double vacuum)
+        {
+          return typename basic<T>::type(matter, vacuum);
+        }
+    };
+
+    template<>
+    struct a2_2::basic<double>
+    {
+        typedef impl::flrw_nat_A2_2 type;
+    };
+  } // namespace model
+
+  /**
+   * A FLRW cosmology whose computation case is fixed at compile time
+   *
+   * The methods of milia::flrw, without the switch on the case:
+   * they call the model of the case directly, and the closed forms
+   * of the flat and matter-only models are inline. Model is one of
+   * the tags of milia::model. milia::visit_flrw selects the tag at
+   * run time.
+   *
+   * T is the floating point type of the computations. The parameters
+   * are double and the case is selected in double; the redshifts and
+   * the results are of type T. The relative accuracy of the flat
+   * models for 0 < z < 1100 and matter in [0.05, 1] is 2e-6 in float,
+   * 1e-14 in double and 2e-17 in 80-bit long double, checked in
+   * tests/ScalarTypeTest.cc.
+   *
+   * The const methods can be called concurrently on the same object.
+   */
+  template<class Model, class T = double>
+  class flrw_t
+  {
+    public:
+      typedef typename Model::template basic<T>::type model_type;
+      typedef T value_type;
+
+      /**
+       * @param hubble Hubble parameter in \f$ km\ s^{-1}\ Mpc^{-1} \f$
+       * @param matter matter density
+       * @param vacuum vacuum energy density
+       * @throws std::domain_error if the parameters are not allowed
+       * or do not belong to the case of Model
+       */
+      flrw_t(double hubble, double matter, double vacuum) :
+        m_model(make_model(matter, vacuum)), m_hu(hubble),
+            m_r_h(T(HUBBLE_RADIUS_LD) / T(hubble)),
+            m_t_h(T(HUBBLE_TIME_LD) / T(hubble))
+      {
+        if (m_hu <= 0)
+          throw std::domain_error("hubble parameter <= 0 not allowed");
+      }
+
+      double get_hubble() const
+      {
+        return m_hu;
+      }
+
+      T get_matter() const
+      {
+        return m_model.get_matter();
+      }
+
+      T get_vacuum() const
+      {
+        return m_model.get_vacuum();
+      }
+
+      /// Hubble radius in Mpc
+      T hubble_radius() const
+      {
+        return m_r_h;
+      }
+
+      /// Hubble time in Gyr
+      T hubble_time() const
+      {
+        return m_t_h;
+      }
+
+      const char* model() const
+      {
+        return m_model.model();
+      }
+
+      T dl(T z) const
+      {
+        return m_r_h * m_model.dl(z);
+      }
+
+      T dm(T z) const
+      {
+        return m_r_h * impl::dm(m_model, z);
+      }
+
+      T da(T z) const
+      {
+        return m_r_h * impl::da(m_model, z);
+      }
+
+      T dc(T z) const
+      {
+        return m_r_h * impl::dc(m_model, z);
+      }
+
+      T vol(T z) const
+      {
+        return m_r_h * m_r_h * m_r_h * impl::vol(m_model, z);
+      }
+
+      T age(T z) const
+      {
+        return m_t_h * m_model.age(z);
+      }
+
+      T lt(T z) const
+      {
+        return m_t_h * impl::lt(m_model, z);
+      }
+
+      /// Distance modulus
+      T DM(T z) const
+      {
+        return 5 * std::log10(dl(z)) + 25;
+      }
+
+      void dl(const T* z, T* res, std::size_t n) const
+      {
+        dl(m_model, z, res, n);
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] *= m_r_h;
+      }
+
+      void dm(const T* z, T* res, std::size_t n) const
+      {
+        dl(m_model, z, res, n);
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] *= m_r_h / (1 + z[i]);
+      }
+
+      void da(const T* z, T* res, std::size_t n) const
+      {
+        dl(m_model, z, res, n);
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] *= m_r_h / ((1 + z[i]) * (1 + z[i]));
+      }
+
+      void dc(const T* z, T* res, std::size_t n) const
+      {
+        dl(m_model, z, res, n);
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] = m_r_h * m_model.dc_from_dm(res[i] / (1 + z[i]));
+      }
+
+      void vol(const T* z, T* res, std::size_t n) const
+      {
+        const T r3 = m_r_h * m_r_h * m_r_h;
+        dl(m_model, z, res, n);
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] = r3 * m_model.vol_from_dm(res[i] / (1 + z[i]));
+      }
+
+      void age(const T* z, T* res, std::size_t n) const
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] = m_t_h * m_model.age(z[i]);
+      }
+
+      void lt(const T* z, T* res, std::size_t n) const
+      {
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] = m_t_h * impl::lt(m_model, z[i]);
+      }
+
+      void DM(const T* z, T* res, std::size_t n) const
+      {
+        dl(z, res, n);
+        for (std::size_t i = 0; i < n; ++i)
+          res[i] = 5 * std::log10(res[i]) + 25;
+      }
+
+      /// Several quantities, as milia::flrw::eval
+      void eval(T z, unsigned mask, quantity_values& res) const
+      {
+        unsigned nat = mask;
+        if (mask & Q_MODULUS)
+          nat |= Q_DL;
+        if (mask & Q_ANGULAR_SCALE)
+          nat |= Q_DA;
+        impl::eval(m_model, z, nat, res);
+        if (nat & Q_DL)
+          res.dl *= m_r_h;
+        if (nat & Q_DA)
+          res.da *= m_r_h;
+        if (mask & Q_DM)
+          res.dm *= m_r_h;
+        if (mask & Q_DC)
+          res.dc *= m_r_h;
+        if (mask & Q_VOL)
+          res.vol *= m_r_h * m_r_h * m_r_h;
+        if (mask & Q_AGE)
+          res.age *= m_t_h;
+        if (mask & Q_LT)
+          res.lt *= m_t_h;
+        if (mask & Q_MODULUS)
+          res.modulus = 5 * std::log10(res.dl) + 25;
+        if (mask & Q_ANGULAR_SCALE)
+          res.angular_scale = res.da * 1e6 / ARCSEC_PER_RAD;
+      }
+
+    private:
+      static model_type make_model(double matter, double vacuum)
+      {
+        if (impl::flrw_nat_model::select(matter, vacuum) != Model::id)
+          throw std::domain_error(
+              "matter and vacuum not in the case of the model");
+        return Model::template make<T>(matter, vacuum);
+      }
+
+      // the array dl of the model, overloaded in impl
+      static void dl(const model_type& m, const T* z, T* res,
+          std::size_t n)
+      {
+        impl::dl(m, z, res, n);
+      }
+
+      model_type m_model;
+      double m_hu;
+      T m_r_h;
+      T m_t_h;
+  };
+
+  /**
+   * Calls v with the milia::flrw_t of the case of matter and vacuum
+   *
+   * Visitor has a typedef result_type and a template
+   * operator()(const flrw_t<Model>&) const. The case is selected once,
+   * the calls inside the visitor are resolved at compile time.
+   *
+   * @throws std::domain_error if the parameters are not allowed
+   */
+  template<class Visitor>
+  typename Visitor::result_type visit_flrw(double hubble, double matter,
+      double vacuum, const Visitor& v)
+  {
+    switch (impl::flrw_nat_model::select(matter, vacuum))
+    {
+      case impl::flrw_nat_model::OM_OV_0:
+        return v(flrw_t<model::empty> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::OV_1:
+        return v(flrw_t<model::open_matter> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::OV_2:
+        return v(flrw_t<model::closed_matter> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::OV_EDS:
+        return v(flrw_t<model::eds> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::OM:
+        return v(flrw_t<model::vacuum_only> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::OM_DS:
+        return v(flrw_t<model::de_sitter> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::OM_OV_1:
+        return v(flrw_t<model::flat_lcdm> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::A1:
+        return v(flrw_t<model::a1> (hubble, matter, vacuum));
+      case impl::flrw_nat_model::A2_1:
+        return v(flrw_t<model::a2_1> (hubble, matter, vacuum));
+      default:
+        return v(flrw_t<model::a2_2> (hubble, matter, vacuum));
+    }
+  }
+
+} // namespace milia
+
+#endif /* MILIA_FLRW_T_H */
@@ -0,0 +1,439 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/math/constants/constants.hpp>
+#include <boost/math/special_functions/expm1.hpp>
+
+#include "flrw_table.h"
+#include "flrw_prec.h"
+#include "vmath.h"
+
+using std::abs;
+using std::cos;
+
+using boost::math::expm1;
+
+namespace
+{
+  // Degree of the polynomials
+  const std::size_t DEGREE = 8;
+  // Number of coefficients per piece
+  const std::size_t NCOEF = DEGREE + 1;
+  // Points per piece where the error is checked, the ends included
+  const std::size_t NCHECK = 3 * NCOEF + 1;
+  // The tables are built to the tolerance divided by this factor
+  const double SAFETY = 2;
+  // Limit of the number of pieces
+  const std::size_t MAXPIECES = 1 << 14;
+
+  // Chebyshev series to powers of u, in place
+  // The evaluation is then a Horner scheme, DEGREE multiply-adds
+  void to_monomial(double* c)
+  {
+    // tk and tk1 hold the powers of T_k and T_(k-1)
+    double a[NCOEF] = { 0 }, tk[NCOEF] = { 0 }, tk1[NCOEF] = { 0 };
+    tk1[0] = 1;
+    tk[1] = 1;
+    a[0] = c[0];
+    a[1] = c[1];
+    for (std::size_t k = 2; k < NCOEF; ++k)
+    {
+      double next[NCOEF];
+      next[0] = -tk1[0];
+      for (std::size_t j = 1; j < NCOEF; ++j)
+        next[j] = 2 * tk[j - 1] - tk1[j];
+      for (std::size_t j = 0; j < NCOEF; ++j)
+      {
+        tk1[j] = tk[j];
+        tk[j] = next[j];
+        a[j] += c[k] * next[j];
+      }
+    }
+    std::copy(a, a + NCOEF, c);
+  }
+
+  inline double scale_power(double z, int power)
+  {
+    switch (power)
+    {
+      case 1:
+        return z;
+      case 3:
+        return z * z * z;
+      default:
+        return 1;
+    }
+  }
+}
+
+namespace milia
+{
+    flrw_table::flrw_table(const flrw& metric, double zmin, double zmax,
+        double rtol) :
+      m_metric(metric), m_zmin(zmin), m_zmax(zmax), m_rtol(rtol)
+    {
+      if (!(zmin >= 0 && zmax > zmin))
+        throw std::domain_error("Range of the table must be 0 <= zmin < zmax");
+      if (!(rtol > 0))
+        throw std::domain_error("Tolerance <= 0 not allowed");
+
+      // dl and da come from dm, they have the same relative error
+      build(m_dm, Q_DM, 1);
+      build(m_dc, Q_DC, 1);
+      build(m_vol, Q_VOL, 3);
+      build(m_age, Q_AGE, 0);
+      build(m_lt, Q_LT, 1);
+    }
+
+    std::string flrw_table::to_string() const
+    {
+      std::stringstream out;
+      out << "flrw_table(" << m_metric.to_string() << ", zmin=" << m_zmin
+          << ", zmax=" << m_zmax << ", rtol=" << m_rtol << ")";
+      return out.str();
+    }
+
+    void flrw_table::exact(quantity q, const double* z, double* res,
+        std::size_t n) const
+    {
+      switch (q)
+      {
+        case Q_DM:
+          m_metric.dm(z, res, n);
+          break;
+        case Q_DC:
+          m_metric.dc(z, res, n);
+          break;
+        case Q_VOL:
+          m_metric.vol(z, res, n);
+          break;
+        case Q_AGE:
+          m_metric.age(z, res, n);
+          break;
+        case Q_LT:
+          m_metric.lt(z, res, n);
+          break;
+        default:
+          std::fill(res, res + n, 0.);
+      }
+    }
+
+    // The quantity divided by z^power is smooth and does not vanish
+    // at z = 0, so its relative error can be controlled down to zmin = 0.
+    // The nodes are the zeros of T_(DEGREE + 1), they are interior, z is
+    // never 0. All the pieces are halved until every piece passes
+    // the check, so that the piece of z is found without a search.
+    // The interpolation error is close to a multiple of T_(DEGREE + 1),
+    // the check points include its extremes and the ends of the piece.
+    // Halving the pieces divides the interpolation error by about
+    // 2^(DEGREE + 1); when the error does not decrease, it comes from
+    // the exact values, which lose digits at low z in non-flat models
+    void flrw_table::build(piecewise& t, quantity q, int power)
+    {
+      const double pi = boost::math::constants::pi<double>();
+      const double x0 = vmath::log1p(m_zmin);
+      const double width = vmath::log1p(m_zmax) - x0;
+
+      double node[NCOEF], check[NCHECK];
+      for (std::size_t k = 0; k < NCOEF; ++k)
+        node[k] = cos(pi * (k + 0.5) / NCOEF);
+      for (std::size_t k = 0; k < NCHECK; ++k)
+        check[k] = cos(pi * k / (NCHECK - 1));
+
+      t.x0 = x0;
+      t.power = power;
+      std::vector<double> z, f;
+      // errors of the last two doublings
+      double last = 0, older = 0;
+      for (std::size_t pieces = 1; pieces <= MAXPIECES; pieces *= 2)
+      {
+        const double h = width / pieces;
+        t.pieces = pieces;
+        t.scale = pieces / width;
+
+        z.resize(pieces * NCOEF);
+        f.resize(pieces * NCOEF);
+        for (std::size_t p = 0; p < pieces; ++p)
+          for (std::size_t k = 0; k < NCOEF; ++k)
+            z[p * NCOEF + k] = expm1(x0 + h * (p + 0.5 * (node[k] + 1)));
+        exact(q, &z[0], &f[0], z.size());
+
+        t.coef.assign(pieces * NCOEF, 0.);
+        for (std::size_t p = 0; p < pieces; ++p)
+        {
+          double* c = &t.coef[p * NCOEF];
+          for (std::size_t k = 0; k < NCOEF; ++k)
+          {
+            const double fk = f[p * NCOEF + k] / scale_power(z[p * NCOEF + k],
+                power);
+            for (std::size_t j = 0; j < NCOEF; ++j)
+              c[j] += fk * cos(pi * j * (k + 0.5) / NCOEF);
+          }
+          for (std::size_t j = 0; j < NCOEF; ++j)
+            c[j] *= 2.0 / NCOEF;
+          c[0] *= 0.5;
+          to_monomial(c);
+        }
+
+        z.resize(pieces * NCHECK);
+        f.resize(pieces * NCHECK);
+        for (std::size_t p = 0; p < pieces; ++p)
+          for (std::size_t k = 0; k < NCHECK; ++k)
+            z[p * NCHECK + k] = expm1(x0 + h * (p + 0.5 * (check[k] + 1)));
+        exact(q, &z[0], &f[0], z.size());
+
+        // z = 0 is skipped, the quantities but the age vanish there
+        double err = 0;
+        for (std::size_t i = 0; i < z.size(); ++i)
+          if (z[i] > 0)
+            err = std::max(err, abs(value(t, z[i]) - f[i]) / abs(f[i]));
+        if (err <= m_rtol / SAFETY)
+          return;
+        if (pieces > 2 && !(err < older))
+          break;
+        older = last;
+        last = err;
+      }
+      throw std::runtime_error("The tolerance of the table can not be reached");
+    }
+
+    double flrw_table::value(const piecewise& t, double z) const
+    {
+      const double s = (vmath::log1p(z) - t.x0) * t.scale;
+      const std::size_t p = s > 0 ? std::min(std::size_t(s), t.pieces - 1) : 0;
+      const double u = 2 * (s - p) - 1;
+      const double* c = &t.coef[p * NCOEF];
+      double v = c[DEGREE];
+      for (std::size_t j = DEGREE; j > 0; --j)
+        v = v * u + c[j - 1];
+      return v * scale_power(z, t.power);
+    }
+
+    // The lanes of a block run the Horner scheme together, the
+    // redshifts out of the range go through the exact methods
+    void flrw_table::values(const piecewise& t, quantity q, const double* z,
+        double* res, std::size_t n) const
+    {
+      const double x0 = t.x0;
+      const double scale = t.scale;
+      const double top = t.pieces - 1;
+      for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+      {
+        const std::size_t w = std::min(FLRW_BLOCK, n - i);
+        const double* zb = z + i;
+        double u[FLRW_BLOCK], v[FLRW_BLOCK];
+        const double* c[FLRW_BLOCK];
+        for (std::size_t l = 0; l < w; ++l)
+        {
+          const double s = (vmath::log1p(zb[l]) - x0) * scale;
+          // s >= 0 in the range, the conversion truncates
+          const double p = std::min(double(long(std::max(s, 0.))), top);
+          u[l] = 2 * (s - p) - 1;
+          c[l] = &t.coef[std::size_t(p) * NCOEF];
+          v[l] = c[l][DEGREE];
+        }
+        for (std::size_t j = DEGREE; j > 0; --j)
+          for (std::size_t l = 0; l < w; ++l)
+            v[l] = v[l] * u[l] + c[l][j - 1];
+        for (std::size_t l = 0; l < w; ++l)
+          res[i + l] = v[l] * scale_power(zb[l], t.power);
+        for (std::size_t l = 0; l < w; ++l)
+          if (!in_range(zb[l]))
+            exact(q, zb + l, res + i + l, 1);
+      }
+    }
+
+    double flrw_table::dc(double z) const
+    {
+      return in_range(z) ? value(m_dc, z) : m_metric.dc(z);
+    }
+
+    double flrw_table::dm(double z) const
+    {
+      return in_range(z) ? value(m_dm, z) : m_metric.dm(z);
+    }
+
+    double flrw_table::da(double z) const
+    {
+      return dm(z) / (1 + z);
+    }
+
+    double flrw_table::dl(double z) const
+    {
+      return dm(z) * (1 + z);
+    }
+
+    double flrw_table::DM(double z) const
+    {
+      return 5 * log10(dl(z)) + 25;
+    }
+
+    double flrw_table::vol(double z) const
+    {
+      return in_range(z) ? value(m_vol, z) : m_metric.vol(z);
+    }
+
+    double flrw_table::age(double z) const
+    {
+      return in_range(z) ? value(m_age, z) : m_metric.age(z);
+    }
+
+    double flrw_table::lt(double z) const
+    {
+      return in_range(z) ? value(m_lt, z) : m_metric.lt(z);
+    }
+
+    double flrw_table::angular_scale(double z) const
+    {
+      return da(z) * 1e6 / ARCSEC_PER_RAD;
+    }
+
+    void flrw_table::dc(const double* z, double* res, std::size_t n) const
+    {
+      values(m_dc, Q_DC, z, res, n);
+    }
+
+    void flrw_table::dm(const double* z, double* res, std::size_t n) const
+    {
+      values(m_dm, Q_DM, z, res, n);
+    }
+
+    void flrw_table::da(const double* z, double* res, std::size_t n) const
+    {
+      dm(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] /= 1 + z[i];
+    }
+
+    void flrw_table::dl(const double* z, double* res, std::size_t n) const
+    {
+      dm(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] *= 1 + z[i];
+    }
+
+    void flrw_table::DM(const double* z, double* res, std::size_t n) const
+    {
+      dl(z, res, n);
+      for (std::size_t i = 0; i < n; ++i)
+        res[i] = 5 * log10(res[i]) + 25;
+    }
+
+    void flrw_table::vol(const double* z, double* res, std::size_t n) const
+    {
+      values(m_vol, Q_VOL, z, res, n);
+    }
+
+    void flrw_table::age(const double* z, double* res, std::size_t n) const
+    {
+      values(m_age, Q_AGE, z, res, n);
+    }
+
+    void flrw_table::lt(const double* z, double* res, std::size_t n) const
+    {
+      values(m_lt, Q_LT, z, res, n);
+    }
+
+    void flrw_table::eval(double z, unsigned mask, quantity_values& res) const
+    {
+      if (!in_range(z))
+      {
+        m_metric.eval(z, mask, res);
+        return;
+      }
+      if (mask & (Q_DL | Q_DA | Q_DM | Q_MODULUS | Q_ANGULAR_SCALE))
+      {
+        const double m = value(m_dm, z);
+        const double l = m * (1 + z);
+        const double a = m / (1 + z);
+        if (mask & Q_DL)
+          res.dl = l;
+        if (mask & Q_DA)
+          res.da = a;
+        if (mask & Q_DM)
+          res.dm = m;
+        if (mask & Q_MODULUS)
+          res.modulus = 5 * log10(l) + 25;
+        if (mask & Q_ANGULAR_SCALE)
+          res.angular_scale = a * 1e6 / ARCSEC_PER_RAD;
+      }
+      if (mask & Q_DC)
+        res.dc = value(m_dc, z);
+      if (mask & Q_VOL)
+        res.vol = value(m_vol, z);
+      if (mask & Q_AGE)
+        res.age = value(m_age, z);
+      if (mask & Q_LT)
+        res.lt = value(m_lt, z);
+    }
+
+    void flrw_table::eval(const double* z, std::size_t n, unsigned mask,
+        const quantity_columns& res) const
+    {
+      double m[FLRW_BLOCK];
+      for (std::size_t i = 0; i < n; i += FLRW_BLOCK)
+      {
+        const std::size_t w = std::min(FLRW_BLOCK, n - i);
+        const double* zb = z + i;
+        if (mask & (Q_DL | Q_DA | Q_DM | Q_MODULUS | Q_ANGULAR_SCALE))
+        {
+          double* cm = (mask & Q_DM) ? res.dm + i : m;
+          dm(zb, cm, w);
+          if (mask & Q_DL)
+            for (std::size_t j = 0; j < w; ++j)
+              res.dl[i + j] = cm[j] * (1 + zb[j]);
+          if (mask & Q_DA)
+            for (std::size_t j = 0; j < w; ++j)
+              res.da[i + j] = cm[j] / (1 + zb[j]);
+          if (mask & Q_MODULUS)
+            for (std::size_t j = 0; j < w; ++j)
+              res.modulus[i + j] = 5 * log10(cm[j] * (1 + zb[j])) + 25;
+          if (mask & Q_ANGULAR_SCALE)
+            for (std::size_t j = 0; j < w; ++j)
+              res.angular_scale[i + j] = cm[j] / (1 + zb[j]) * 1e6
+                  / ARCSEC_PER_RAD;
+        }
+        if (mask & Q_DC)
+          dc(zb, res.dc + i, w);
+        if (mask & Q_VOL)
+          vol(zb, res.vol + i, w);
+        if (mask & Q_AGE)
+          age(zb, res.age + i, w);
+        if (mask & Q_LT)
+          lt(zb, res.lt + i, w);
+      }
+    }
+
+} //namespace milia
+
+std::ostream& operator<<(std::ostream& os, milia::flrw_table& table)
+{
+  os << table.to_string();
+  return os;
+}
@@ -0,0 +1,381 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_FLRW_TABLE_H
+#define MILIA_FLRW_TABLE_H
+
+#include <milia/flrw.h>
+
+#include <string>
+#include <ostream>
+#include <vector>
+#include <cstddef>
+
+namespace milia
+{
+    /**
+     * Tabulated FLRW metric
+     *
+     * The distances, volume and times of a milia::flrw are approximated
+     * in a range of redshifts with piecewise Chebyshev polynomials in
+     * \f$ \log(1 + z) \f$. The pieces are built from the exact methods
+     * and halved until the relative error, estimated against the exact
+     * methods at the extremes of the interpolation error of every piece,
+     * is below half the tolerance. The tables are not more accurate
+     * than the exact methods, which lose digits at low z in non-flat
+     * models (about \f$ 10^{-15} / z \f$); there the tables are
+     * closer to the true values than the exact methods.
+     *
+     * The class has the methods of milia::flrw. Outside the range,
+     * the exact methods are used.
+     *
+     * Thread safety: the const methods can be called concurrently
+     * on the same object.
+     */
+    class flrw_table
+    {
+      public:
+
+        /**
+         * Builds the tables
+         *
+         * @param metric the metric to tabulate, it is copied
+         * @param zmin lower redshift of the tables
+         * @param zmax upper redshift of the tables
+         * @param rtol estimated maximum relative error in the range
+         * @throws std::domain_error if the range is not valid
+         * @throws std::runtime_error if the tolerance can not be reached,
+         * when halving the pieces twice does not reduce the error
+         */
+        flrw_table(const flrw& metric, double zmin, double zmax,
+            double rtol = 1e-10);
+
+        /**
+         * The exact metric
+         */
+        const flrw& get_metric() const;
+
+        /**
+         * Lower redshift of the tables
+         */
+        double get_zmin() const;
+
+        /**
+         * Upper redshift of the tables
+         */
+        double get_zmax() const;
+
+        /**
+         * Relative error of the tables
+         */
+        double get_rtol() const;
+
+        /**
+         * Get the value of the matter density \f[\Omega_m \f]
+         */
+        double get_matter() const;
+
+        /**
+         * Get the value of the vacuum energy density \f[ \Omega_v \f]
+         */
+        double get_vacuum() const;
+
+        /**
+         * Get the value of the Hubble parameter in \f$ km\ s^{-1}\ Mpc^{-1} \f$.
+         */
+        double get_hubble() const;
+
+        /**
+         * Computes the Hubble parameter at redshift z, not tabulated
+         *
+         * @param z redshift
+         * @return the Hubble parameter at the given redshift
+         */
+        double get_hubble(double z) const;
+
+        /**
+         * Comoving distance (line of sight) in Mpc
+         *
+         * @param z redshift
+         * @return line of sight comoving distance in Mpc
+         */
+        double dc(double z) const;
+
+        /**
+         * Comoving distance (transverse) in Mpc
+         *
+         * @param z redshift
+         * @return transverse comoving distance in Mpc
+         */
+        double dm(double z) const;
+
+        /**
+         * Angular distance in Mpc
+         *
+         * @param z redshift
+         * @return the angular distance in Mpc
+         */
+        double da(double z) const;
+
+        /**
+         * Luminosity distance in Mpc
+         *
+         * @param z redshift
+         * @return the luminosity distance in Mpc
+         */
+        double dl(double z) const;
+
+        /**
+         * Distance modulus \f$ DM = 5 log(\frac{D_l}{10\ pc}) \f$
+         *
+         * @param z redshift
+         * @return distance modulus in mag
+         */
+        double DM(double z) const;
+
+        /**
+         * Comoving volume per solid angle
+         *
+         * @param z redshift
+         * @return comoving volume in \f$ Mpc^3\f$ per solid angle
+         */
+        double vol(double z) const;
+
+        /**
+         * Current age of the Universe
+         */
+        double age() const;
+
+        /**
+         * Age of the Universe in Gyr
+         *
+         * @param z redshift
+         * @return Age of the Universe in Gyr
+         */
+        double age(double z) const;
+
+        /**
+         * Look-back time in Gyr
+         *
+         * @param z redshift
+         * @return Look-back time in Gyr
+         */
+        double lt(double z) const;
+
+        /**
+         * Factor to transform angular sizes in arc seconds into parsecs
+         *
+         * @param z redshift
+         * @return scale factor.
+         */
+        double angular_scale(double z) const;
+
+        /**
+         * Comoving distance (line of sight) in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dc(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Comoving distance (transverse) in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dm(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Angular distance in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void da(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Luminosity distance in Mpc for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the distances are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void dl(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Distance modulus in mag for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the moduli are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void DM(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Comoving volume per solid angle in \f$ Mpc^3\f$ for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the volumes are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void vol(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Age of the Universe in Gyr for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the ages are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void age(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Look-back time in Gyr for an array of redshifts
+         *
+         * @param z array of redshifts
+         * @param res array where the times are stored, must not overlap z
+         * @param n number of elements in z and res
+         */
+        void lt(const double* z, double* res, std::size_t n) const;
+
+        /**
+         * Computes several quantities. Units are those of the
+         * individual methods.
+         *
+         * @param z redshift
+         * @param mask quantities to compute, a combination of milia::quantity
+         * @param res where the requested quantities are stored
+         */
+        void eval(double z, unsigned mask, quantity_values& res) const;
+
+        /**
+         * Computes several quantities for an array of redshifts.
+         *
+         * @param z array of redshifts
+         * @param n number of elements in z and in the output arrays
+         * @param mask quantities to compute, a combination of milia::quantity
+         * @param res arrays where the requested quantities are stored,
+         * they must not overlap z or each other
+         */
+        void eval(const double* z, std::size_t n, unsigned mask,
+            const quantity_columns& res) const;
+
+        /**
+         * String with the metric and the range of the tables
+         *
+         * @return a string
+         */
+        std::string to_string() const;
+
+      private:
+        // Piecewise Chebyshev approximation of q(z) / z^power,
+        // with pieces of equal width in x = log(1 + z)
+        struct piecewise
+        {
+            // log(1 + zmin)
+            double x0;
+            // Number of pieces per unit of x
+            double scale;
+            std::size_t pieces;
+            int power;
+            // degree + 1 coefficients per piece
+            std::vector<double> coef;
+        };
+
+        void build(piecewise& t, quantity q, int power);
+        // Exact values of the quantity, in the units of flrw
+        void exact(quantity q, const double* z, double* res,
+            std::size_t n) const;
+        double value(const piecewise& t, double z) const;
+        void values(const piecewise& t, quantity q, const double* z,
+            double* res, std::size_t n) const;
+        bool in_range(double z) const;
+
+        const flrw m_metric;
+        double m_zmin;
+        double m_zmax;
+        double m_rtol;
+
+        piecewise m_dm;
+        piecewise m_dc;
+        piecewise m_vol;
+        piecewise m_age;
+        piecewise m_lt;
+    };
+
+    inline const flrw& flrw_table::get_metric() const
+    {
+      return m_metric;
+    }
+
+    inline double flrw_table::get_zmin() const
+    {
+      return m_zmin;
+    }
+
+    inline double flrw_table::get_zmax() const
+    {
+      return m_zmax;
+    }
+
+    inline double flrw_table::get_rtol() const
+    {
+      return m_rtol;
+    }
+
+    inline double flrw_table::get_matter() const
+    {
+      return m_metric.get_matter();
+    }
+
+    inline double flrw_table::get_vacuum() const
+    {
+      return m_metric.get_vacuum();
+    }
+
+    inline double flrw_table::get_hubble() const
+    {
+      return m_metric.get_hubble();
+    }
+
+    inline double flrw_table::get_hubble(double z) const
+    {
+      return m_metric.get_hubble(z);
+    }
+
+    inline double flrw_table::age() const
+    {
+      return m_metric.age();
+    }
+
+    inline bool flrw_table::in_range(double z) const
+    {
+      return z >= m_zmin && z <= m_zmax;
+    }
+
+} // namespace milia
+
+std::ostream& operator<<(std::ostream& os, milia::flrw_table& table);
+
+#endif /* MILIA_FLRW_TABLE_H */
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "grid.h"
+
+#include "flrw_prec.h"
+#include "metric.h"
+
+namespace
+{
+  // Flags of a cell, from the checks of metric.h
+  // The cells with flags are not constructed, so that the
+  // large invalid regions of the plane do not throw
+  unsigned char cell_flags(milia::quantity q, double matter, double vacuum)
+  {
+    if (matter < 0)
+      return milia::GRID_ERROR;
+    const bool empty = std::abs(matter) < FLRW_EQ_TOL;
+    // flrw_nat accepts an empty Universe with vacuum > 1, but it has
+    // no computation case and its methods return -1
+    if (empty && vacuum > 1 + FLRW_EQ_TOL)
+      return milia::GRID_ERROR;
+    // the age of the de Sitter Universe is infinite
+    if (q == milia::Q_AGE && empty && std::abs(vacuum - 1) < FLRW_EQ_TOL)
+      return milia::GRID_ERROR;
+    unsigned char flags = milia::GRID_VALID;
+    if (!milia::check_bigbang(matter, vacuum))
+      flags |= milia::GRID_NO_BIGBANG;
+    if (milia::check_recollapse(matter, vacuum))
+      flags |= milia::GRID_RECOLLAPSE;
+    return flags;
+  }
+
+  // Column of q in the eval methods
+  double*& column(milia::quantity_columns& cols, milia::quantity q)
+  {
+    switch (q)
+    {
+      case milia::Q_DL:
+        return cols.dl;
+      case milia::Q_DA:
+        return cols.da;
+      case milia::Q_DM:
+        return cols.dm;
+      case milia::Q_DC:
+        return cols.dc;
+      case milia::Q_VOL:
+        return cols.vol;
+      case milia::Q_AGE:
+        return cols.age;
+      case milia::Q_LT:
+        return cols.lt;
+      case milia::Q_MODULUS:
+        return cols.modulus;
+      default:
+        return cols.angular_scale;
+    }
+  }
+
+  // The rows of the matter axis
+  class grid_task: public milia::thread_pool::task
+  {
+    public:
+      grid_task(milia::quantity q, double hubble, const double* matter,
+          const double* vacuum, std::size_t nv, const double* z,
+          std::size_t nz, const milia::grid_output& res,
+          const milia::grid_mask& mask) :
+        m_q(q), m_hubble(hubble), m_matter(matter), m_vacuum(vacuum),
+            m_nv(nv), m_z(z), m_nz(nz), m_res(res), m_mask(mask)
+      {
+      }
+
+      void operator()(std::size_t i)
+      {
+        std::vector<double> values(m_nz);
+        milia::quantity_columns cols = milia::quantity_columns();
+        column(cols, m_q) = m_nz > 0 ? &values[0] : 0;
+        const double om = m_matter[i];
+        for (std::size_t j = 0; j < m_nv; ++j)
+        {
+          const double ov = m_vacuum[j];
+          unsigned char flags = cell_flags(m_q, om, ov);
+          if (flags == milia::GRID_VALID)
+          {
+            try
+            {
+              if (m_hubble > 0)
+                milia::flrw(m_hubble, om, ov).eval(m_z, m_nz, m_q, cols);
+              else
+                milia::flrw_nat(om, ov).eval(m_z, m_nz, m_q, cols);
+            }
+            catch (const std::domain_error&)
+            {
+              flags = milia::GRID_ERROR;
+            }
+            catch (const std::runtime_error&)
+            {
+              flags = milia::GRID_ERROR;
+            }
+          }
+          if (flags != milia::GRID_VALID)
+            std::fill(values.begin(), values.end(),
+                std::numeric_limits<double>::quiet_NaN());
+
+          double* out = m_res.data + std::ptrdiff_t(i) * m_res.matter_stride
+              + std::ptrdiff_t(j) * m_res.vacuum_stride;
+          for (std::size_t k = 0; k < m_nz; ++k)
+            out[std::ptrdiff_t(k) * m_res.z_stride] = values[k];
+          if (m_mask.data)
+            m_mask.data[std::ptrdiff_t(i) * m_mask.matter_stride
+                + std::ptrdiff_t(j) * m_mask.vacuum_stride] = flags;
+        }
+      }
+
+    private:
+      milia::quantity m_q;
+      double m_hubble;
+      const double* m_matter;
+      const double* m_vacuum;
+      std::size_t m_nv;
+      const double* m_z;
+      std::size_t m_nz;
+      milia::grid_output m_res;
+      milia::grid_mask m_mask;
+  };
+}
+
+namespace milia
+{
+    void grid_eval(thread_pool& pool, quantity q, double hubble,
+        const double* matter, std::size_t nm, const double* vacuum,
+        std::size_t nv, const double* z, std::size_t nz,
+        const grid_output& res, const grid_mask& mask)
+    {
+      const unsigned bits = q;
+      if (bits == 0 || (bits & (bits - 1)) != 0 || (bits & ~unsigned(Q_ALL)))
+        throw std::domain_error("A single quantity is required");
+      if (hubble < 0)
+        throw std::domain_error("Hubble constant < 0 not allowed");
+      if (hubble == 0 && (q == Q_MODULUS || q == Q_ANGULAR_SCALE))
+        throw std::domain_error("Quantity not available in natural units");
+
+      grid_task t(q, hubble, matter, vacuum, nv, z, nz, res, mask);
+      pool.run(t, nm);
+    }
+
+    void grid_eval(unsigned nthreads, quantity q, double hubble,
+        const double* matter, std::size_t nm, const double* vacuum,
+        std::size_t nv, const double* z, std::size_t nz,
+        const grid_output& res, const grid_mask& mask)
+    {
+      thread_pool pool(nthreads);
+      grid_eval(pool, q, hubble, matter, nm, vacuum, nv, z, nz, res, mask);
+    }
+
+} // namespace milia
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_GRID_H
+#define MILIA_GRID_H
+
+#include <milia/parallel.h>
+#include <milia/quantities.h>
+
+#include <cstddef>
+
+namespace milia
+{
+    /**
+     * Flags of the cells of milia::grid_eval
+     */
+    enum grid_flag
+    {
+      GRID_VALID = 0, //!< the quantity is computed
+      GRID_NO_BIGBANG = 1 << 0, //!< no Big Bang, see milia::check_bigbang
+      GRID_RECOLLAPSE = 1 << 1, //!< the Universe recollapses, see milia::check_recollapse
+      GRID_ERROR = 1 << 2 //!< other parameters not allowed, a quantity without a value, or the computation failed
+    };
+
+    /**
+     * Output of milia::grid_eval
+     *
+     * The value of matter[i], vacuum[j], z[k] is stored in
+     * data[i * matter_stride + j * vacuum_stride + k * z_stride].
+     * The strides are in elements and may be negative.
+     */
+    struct grid_output
+    {
+        double* data;
+        std::ptrdiff_t matter_stride;
+        std::ptrdiff_t vacuum_stride;
+        std::ptrdiff_t z_stride;
+    };
+
+    /**
+     * Flags of the cells of milia::grid_eval, a combination of
+     * milia::grid_flag
+     *
+     * The flags of matter[i], vacuum[j] are stored in
+     * data[i * matter_stride + j * vacuum_stride]. data may be null.
+     */
+    struct grid_mask
+    {
+        unsigned char* data;
+        std::ptrdiff_t matter_stride;
+        std::ptrdiff_t vacuum_stride;
+    };
+
+    /**
+     * Computes a quantity over a grid of matter and vacuum densities
+     * and redshifts
+     *
+     * Each cell is a milia::flrw (or a milia::flrw_nat if hubble is 0)
+     * evaluated at all the redshifts. The cells without a Big Bang or that
+     * recollapse, as found by milia::check_bigbang and
+     * milia::check_recollapse, are not computed; their flags are stored
+     * in the mask and their values are NaN. Errors of the other cells are
+     * not thrown either, they are flagged with GRID_ERROR. So are the
+     * empty Universes with vacuum > 1, which have no computation case,
+     * and the age of the de Sitter Universe, which is infinite.
+     *
+     * The rows of the matter axis are computed in parallel by the threads
+     * of the pool.
+     *
+     * @param pool the threads
+     * @param q quantity to compute, one of milia::quantity
+     * @param hubble Hubble parameter in \f$ km\ s^{-1}\ Mpc^{-1} \f$,
+     * 0 for natural units
+     * @param matter array of matter densities
+     * @param nm number of matter densities
+     * @param vacuum array of vacuum energy densities
+     * @param nv number of vacuum densities
+     * @param z array of redshifts
+     * @param nz number of redshifts
+     * @param res where the values are stored
+     * @param mask where the flags are stored
+     * @throws std::domain_error if q is not a single quantity, if hubble
+     * is negative or if q is Q_MODULUS or Q_ANGULAR_SCALE in natural units
+     */
+    void grid_eval(thread_pool& pool, quantity q, double hubble,
+        const double* matter, std::size_t nm, const double* vacuum,
+        std::size_t nv, const double* z, std::size_t nz,
+        const grid_output& res, const grid_mask& mask);
+
+    /**
+     * Computes a quantity over a grid with a new pool
+     *
+     * @param nthreads number of threads, 0 for the number of online processors
+     * @see grid_eval(thread_pool&, quantity, double, const double*, std::size_t,
+     * const double*, std::size_t, const double*, std::size_t,
+     * const grid_output&, const grid_mask&)
+     */
+    void grid_eval(unsigned nthreads, quantity q, double hubble,
+        const double* matter, std::size_t nm, const double* vacuum,
+        std::size_t nv, const double* z, std::size_t nz,
+        const grid_output& res, const grid_mask& mask);
+
+} // namespace milia
+
+#endif /* MILIA_GRID_H */
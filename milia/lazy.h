@@ -0,0 +1,97 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_LAZY_H
+#define MILIA_LAZY_H
+
+namespace milia
+{
+  namespace detail
+  {
+    // A value computed on first use by const methods
+    //
+    // Concurrent readers may compute the value more than once, the
+    // first one to finish stores it. The state is read and written
+    // with the __sync builtins of GCC, which are full barriers, so
+    // the value is only read after it has been stored.
+    class lazy_double
+    {
+      public:
+        lazy_double() :
+          m_state(EMPTY), m_value(0)
+        {
+        }
+
+        lazy_double(const lazy_double& other) :
+          m_state(EMPTY), m_value(0)
+        {
+          double v;
+          if (other.get(v))
+            set(v);
+        }
+
+        lazy_double& operator=(const lazy_double& other)
+        {
+          if (this != &other)
+          {
+            reset();
+            double v;
+            if (other.get(v))
+              set(v);
+          }
+          return *this;
+        }
+
+        // True if the value has been stored, the value is returned in v
+        bool get(double& v) const
+        {
+          if (__sync_fetch_and_add(&m_state, 0) != READY)
+            return false;
+          v = m_value;
+          return true;
+        }
+
+        // Stores v, unless other thread is storing or has stored it
+        void set(double v) const
+        {
+          if (!__sync_bool_compare_and_swap(&m_state, EMPTY, BUSY))
+            return;
+          m_value = v;
+          __sync_bool_compare_and_swap(&m_state, BUSY, READY);
+        }
+
+        // Forgets the value, not safe with concurrent readers
+        void reset()
+        {
+          m_state = EMPTY;
+        }
+
+      private:
+        enum state
+        {
+          EMPTY, BUSY, READY
+        };
+        mutable int m_state;
+        mutable double m_value;
+    };
+  }
+} // namespace milia
+
+#endif /* MILIA_LAZY_H */
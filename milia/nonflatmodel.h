@@ -23,8 +23,8 @@
 
 #include <boost/math/special_functions/pow.hpp>
 
+#include "closed_form.h"
 #include "flrw_nat_impl.h"
-#include "util.h"
 
 using boost::math::pow;
 
@@ -41,9 +41,8 @@ namespace milia
          m_crit = -13.5 * pow<2> (matter) * vacuum / (pow<3> (1 - matter - vacuum));
        }
 
-        double dc(double z) const;
-
-        double vol(double z) const;
+        double dc_from_dm(double dm) const;
+        double vol_from_dm(double dm) const;
       protected:
         double m_crit;
     };
@@ -54,9 +53,15 @@ namespace milia
         flrw_nat_OM_OV_0(): flrw_nat_nonflat(0.0, 0.0)
         {}
 
-        double dl(double z) const;
+        double dl(double z) const
+        {
+          return closed_form::empty_dl(z);
+        }
 
-        double age(double z) const;
+        double age(double z) const
+        {
+          return closed_form::empty_age(z);
+        }
         const char* model() const;
 
     };
@@ -67,7 +72,10 @@ namespace milia
       flrw_nat_OV(double matter) : flrw_nat_nonflat(matter, 0.0)
       {}
 
-      double dl(double z) const;
+      double dl(double z) const
+      {
+        return closed_form::matter_dl(m_om, z);
+      }
   };
 
   class flrw_nat_OV_1: public flrw_nat_OV 
@@ -76,7 +84,10 @@ namespace milia
       flrw_nat_OV_1(double matter) : flrw_nat_OV(matter)
       {}
 
-      double age(double z) const;
+      double age(double z) const
+      {
+        return closed_form::open_matter_age(m_om, z);
+      }
       const char* model() const;
   };
 
@@ -86,7 +97,10 @@ namespace milia
       flrw_nat_OV_2(double matter) : flrw_nat_OV(matter)
       {}
 
-      double age(double z) const;
+      double age(double z) const
+      {
+        return closed_form::closed_matter_age(m_om, z);
+      }
       const char* model() const;
   };
 
@@ -96,31 +110,66 @@ namespace milia
       flrw_nat_OM(double vacuum) : flrw_nat_nonflat(0.0, vacuum)
       {}
 
-      double dl(double z) const;
-      double age(double z) const;
+      double dl(double z) const
+      {
+        return closed_form::vacuum_dl(m_ov, z);
+      }
+
+      double age(double z) const
+      {
+        return closed_form::vacuum_age(m_ov, z);
+      }
       const char* model() const;
   };
 
   class flrw_nat_A1: public flrw_nat_nonflat 
   {
     public:
-      flrw_nat_A1(double matter, double vacuum) : flrw_nat_nonflat(matter, vacuum)
-      {}
+      flrw_nat_A1(double matter, double vacuum);
 
       double dl(double z) const;
       double age(double z) const;
       const char* model() const;
     private:
-      double ti(double z) const;
+      // Equation 10, given Pi(n10; phi, k)
+      double age_eq10(double z, double phi, double f3) const;
+      // Equation 10 at its node
+      double age_node(double z) const;
+
+      // Terms that depend only on om and ov
+      // om / abs(m_ok)
+      double m_sup;
+      // Root of the cubic polynomial
+      double m_y1;
+      double m_A;
+      // Scale and modulus of the elliptic integrals
+      double m_g;
+      double m_k;
+      // Characteristic of equation 10
+      double m_n10;
+      // Elliptic integral of dl at z = 0
+      double m_ellint0;
   };
 
   class flrw_nat_A2: public flrw_nat_nonflat 
   {
     public:
-      flrw_nat_A2(double matter, double vacuum) : flrw_nat_nonflat(matter, vacuum)
-      {}
+      flrw_nat_A2(double matter, double vacuum);
 
       double dl(double z) const;
+    protected:
+      // Terms that depend only on om and ov
+      // om / abs(m_ok)
+      double m_sup;
+      // Roots of the cubic polynomial
+      double m_y1;
+      double m_y2;
+      double m_y3;
+      // Scale and modulus of the elliptic integrals
+      double m_g;
+      double m_k;
+      // Elliptic integral of dl at z = 0
+      double m_ellint0;
   };
 
   class flrw_nat_A2_1: public flrw_nat_A2
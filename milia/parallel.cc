@@ -0,0 +1,169 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "parallel.h"
+
+namespace milia
+{
+    thread_pool::task::~task()
+    {
+    }
+
+    thread_pool::thread_pool(unsigned nthreads) :
+      m_task(0), m_nchunks(0), m_next(0), m_active(0), m_generation(0),
+          m_stop(false), m_error_kind(ERR_NONE)
+    {
+      if (nthreads == 0)
+      {
+        const long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = ncpu > 0 ? unsigned(ncpu) : 1;
+      }
+      pthread_mutex_init(&m_run, 0);
+      pthread_mutex_init(&m_mutex, 0);
+      pthread_cond_init(&m_start, 0);
+      pthread_cond_init(&m_done, 0);
+      m_threads.reserve(nthreads - 1);
+      for (unsigned i = 1; i < nthreads; ++i)
+      {
+        pthread_t th;
+        if (pthread_create(&th, 0, &thread_pool::worker, this))
+        {
+          shutdown();
+          throw std::runtime_error("The threads of the pool can not be created");
+        }
+        m_threads.push_back(th);
+      }
+    }
+
+    thread_pool::~thread_pool()
+    {
+      shutdown();
+    }
+
+    void thread_pool::shutdown()
+    {
+      pthread_mutex_lock(&m_mutex);
+      m_stop = true;
+      pthread_cond_broadcast(&m_start);
+      pthread_mutex_unlock(&m_mutex);
+      for (std::size_t i = 0; i < m_threads.size(); ++i)
+        pthread_join(m_threads[i], 0);
+      m_threads.clear();
+      pthread_cond_destroy(&m_done);
+      pthread_cond_destroy(&m_start);
+      pthread_mutex_destroy(&m_mutex);
+      pthread_mutex_destroy(&m_run);
+    }
+
+    void* thread_pool::worker(void* pool)
+    {
+      thread_pool* self = static_cast<thread_pool*> (pool);
+      pthread_mutex_lock(&self->m_mutex);
+      unsigned long seen = self->m_generation;
+      for (;;)
+      {
+        while (!self->m_stop && self->m_generation == seen)
+          pthread_cond_wait(&self->m_start, &self->m_mutex);
+        if (self->m_stop)
+          break;
+        seen = self->m_generation;
+        self->work();
+      }
+      pthread_mutex_unlock(&self->m_mutex);
+      return 0;
+    }
+
+    void thread_pool::work()
+    {
+      ++m_active;
+      while (m_next < m_nchunks)
+      {
+        const std::size_t chunk = m_next++;
+        pthread_mutex_unlock(&m_mutex);
+        error_kind kind = ERR_NONE;
+        std::string what;
+        try
+        {
+          (*m_task)(chunk);
+        } catch (const std::domain_error& e)
+        {
+          kind = ERR_DOMAIN;
+          what = e.what();
+        } catch (const std::exception& e)
+        {
+          kind = ERR_RUNTIME;
+          what = e.what();
+        } catch (...)
+        {
+          kind = ERR_RUNTIME;
+          what = "Unknown exception in a chunk";
+        }
+        pthread_mutex_lock(&m_mutex);
+        if (kind != ERR_NONE)
+        {
+          // The first error is kept, no more chunks are started
+          if (m_error_kind == ERR_NONE)
+          {
+            m_error_kind = kind;
+            m_error = what;
+          }
+          m_next = m_nchunks;
+        }
+      }
+      if (--m_active == 0)
+        pthread_cond_broadcast(&m_done);
+    }
+
+    void thread_pool::run(task& t, std::size_t nchunks)
+    {
+      pthread_mutex_lock(&m_run);
+      pthread_mutex_lock(&m_mutex);
+      m_task = &t;
+      m_nchunks = nchunks;
+      m_next = 0;
+      m_error_kind = ERR_NONE;
+      m_error.clear();
+      ++m_generation;
+      pthread_cond_broadcast(&m_start);
+      // The caller works too
+      work();
+      while (m_active > 0)
+        pthread_cond_wait(&m_done, &m_mutex);
+      m_task = 0;
+      const error_kind kind = m_error_kind;
+      const std::string what = m_error;
+      pthread_mutex_unlock(&m_mutex);
+      pthread_mutex_unlock(&m_run);
+
+      if (kind == ERR_DOMAIN)
+        throw std::domain_error(what);
+      if (kind == ERR_RUNTIME)
+        throw std::runtime_error(what);
+    }
+
+} // namespace milia
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_PARALLEL_H
+#define MILIA_PARALLEL_H
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace milia
+{
+    /**
+     * Number of elements of the chunks of milia::parallel
+     *
+     * 2048 redshifts and results use 32 KiB, they stay in the L1 or L2
+     * cache of a core while the array method runs over the chunk.
+     */
+    const std::size_t PARALLEL_CHUNK = 2048;
+
+    /**
+     * Pool of worker threads
+     *
+     * The threads are created once and wait between calls to run,
+     * so that the pool can be reused for many arrays. The thread
+     * calling run works too, a pool of size n starts n - 1 threads.
+     *
+     * Concurrent calls to run are serialized.
+     */
+    class thread_pool
+    {
+      public:
+        /**
+         * Work split in chunks
+         */
+        class task
+        {
+          public:
+            virtual ~task();
+            /**
+             * Processes one chunk, called concurrently for different chunks
+             *
+             * @param chunk index of the chunk
+             */
+            virtual void operator()(std::size_t chunk) = 0;
+        };
+
+        /**
+         * Starts the threads
+         *
+         * @param nthreads number of threads, 0 for the number of online processors
+         * @throws std::runtime_error if the threads can not be created
+         */
+        explicit thread_pool(unsigned nthreads = 0);
+
+        /**
+         * Stops and joins the threads
+         */
+        ~thread_pool();
+
+        /**
+         * Number of threads, including the caller of run
+         */
+        unsigned size() const;
+
+        /**
+         * Runs a task over chunks 0 to nchunks - 1 and waits for it
+         *
+         * The chunks are handed to the threads one at a time, in order.
+         * If a chunk throws, the remaining chunks are not started and
+         * the first exception is thrown again as std::domain_error
+         * or std::runtime_error, with the same message.
+         *
+         * @param t the task
+         * @param nchunks number of chunks
+         */
+        void run(task& t, std::size_t nchunks);
+
+      private:
+        thread_pool(const thread_pool&);
+        thread_pool& operator=(const thread_pool&);
+
+        // Stops and joins the threads, destroys the mutexes
+        void shutdown();
+        static void* worker(void* pool);
+        // Processes chunks until there are none left, the mutex is held
+        void work();
+
+        // Serializes the calls to run
+        pthread_mutex_t m_run;
+        pthread_mutex_t m_mutex;
+        pthread_cond_t m_start;
+        pthread_cond_t m_done;
+        std::vector<pthread_t> m_threads;
+
+        // State of the current run, protected by the mutex
+        task* m_task;
+        std::size_t m_nchunks;
+        std::size_t m_next;
+        unsigned m_active;
+        unsigned long m_generation;
+        bool m_stop;
+
+        // First error of the current run
+        enum error_kind
+        {
+          ERR_NONE, ERR_DOMAIN, ERR_RUNTIME
+        };
+        error_kind m_error_kind;
+        std::string m_error;
+    };
+
+    inline unsigned thread_pool::size() const
+    {
+      return m_threads.size() + 1;
+    }
+
+    namespace detail
+    {
+      // An array method of a metric over a chunk of the array
+      template<class Metric, class Base>
+      class array_task: public thread_pool::task
+      {
+        public:
+          typedef void (Base::*method_type)(const double*, double*,
+              std::size_t) const;
+
+          array_task(const Metric& metric, method_type method,
+              const double* z, double* res, std::size_t n) :
+            m_metric(metric), m_method(method), m_z(z), m_res(res), m_n(n)
+          {
+          }
+
+          void operator()(std::size_t chunk)
+          {
+            const std::size_t first = chunk * PARALLEL_CHUNK;
+            const std::size_t size = std::min(PARALLEL_CHUNK, m_n - first);
+            (m_metric.*m_method)(m_z + first, m_res + first, size);
+          }
+
+        private:
+          const Metric& m_metric;
+          method_type m_method;
+          const double* m_z;
+          double* m_res;
+          std::size_t m_n;
+      };
+    }
+
+    /**
+     * Calls an array method of a metric in parallel
+     *
+     * The array is split in chunks of milia::PARALLEL_CHUNK elements,
+     * the threads of the pool call the method over one chunk at a time.
+     * The results are those of the serial call.
+     *
+     * Any const method with the signature of the array versions can be
+     * used, for example
+     *
+     * \code
+     * milia::parallel(pool, metric, &milia::flrw::dl, z, res, n);
+     * \endcode
+     *
+     * with milia::flrw, milia::flrw_nat or milia::flrw_table. The work
+     * per element is the same, the time scales with the number of
+     * threads once each thread has several chunks.
+     *
+     * @param pool the threads
+     * @param metric the object whose method is called
+     * @param method array method of the metric
+     * @param z array of inputs
+     * @param res array where the results are stored
+     * @param n number of elements in z and res
+     */
+    template<class Metric, class Base>
+    void parallel(thread_pool& pool, const Metric& metric, void(Base::*method)(
+        const double*, double*, std::size_t) const, const double* z,
+        double* res, std::size_t n)
+    {
+      detail::array_task<Metric, Base> t(metric, method, z, res, n);
+      pool.run(t, (n + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK);
+    }
+
+    /**
+     * Calls an array method of a metric in parallel with a new pool
+     *
+     * The threads are created and joined in the call, reuse a
+     * milia::thread_pool for many arrays.
+     *
+     * @param nthreads number of threads, 0 for the number of online processors
+     * @param metric the object whose method is called
+     * @param method array method of the metric
+     * @param z array of inputs
+     * @param res array where the results are stored
+     * @param n number of elements in z and res
+     */
+    template<class Metric, class Base>
+    void parallel(unsigned nthreads, const Metric& metric, void(Base::*method)(
+        const double*, double*, std::size_t) const, const double* z,
+        double* res, std::size_t n)
+    {
+      thread_pool pool(nthreads);
+      parallel(pool, metric, method, z, res, n);
+    }
+
+} // namespace milia
+
+#endif /* MILIA_PARALLEL_H */
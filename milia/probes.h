@@ -0,0 +1,146 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_PROBES_H
+#define MILIA_PROBES_H
+
+// Static probes (USDT) of the provider milia, used by the library
+// sources. With <sys/sdt.h> of systemtap each probe is a nop and a
+// note in the ELF file, that perf, bpftrace or systemtap turn into a
+// breakpoint when attached. configure --disable-probes or a system
+// without <sys/sdt.h> removes them.
+//
+// Probes of flrw_nat, the case is the index of milia/stats.h and the
+// branch a milia::stats::path:
+//   construct__entry(matter, vacuum)
+//   construct__return(matter, vacuum, case)
+//   select__case(matter, vacuum, case)    constructor and setters
+//   dl__entry(z, case), dl__return(z, case)
+//   age__entry(z, case), age__return(z, case)
+//   age__branch(z, case, branch)          inside the age of A1
+//   dl__array__entry(n, case), dl__array__return(n, case)
+//   age__array__entry(n, case), age__array__return(n, case)
+// z, matter and vacuum are doubles, the tools that only read integers
+// get their IEEE 754 bits. For example, the latency of the age per
+// branch with bpftrace:
+//   usdt:libmilia.so:milia:age__entry { @t[tid] = nsecs; @b[tid] = -1 }
+//   usdt:libmilia.so:milia:age__branch { @b[tid] = arg2 }
+//   usdt:libmilia.so:milia:age__return /@t[tid]/ {
+//     @ns[arg1, @b[tid]] = hist(nsecs - @t[tid]); delete(@t[tid]) }
+
+#include <cstddef>
+
+#if defined(HAVE_SYS_SDT_H) && !defined(MILIA_DISABLE_PROBES)
+#include <sys/sdt.h>
+#define MILIA_PROBE1(name, a) DTRACE_PROBE1(milia, name, a)
+#define MILIA_PROBE2(name, a, b) DTRACE_PROBE2(milia, name, a, b)
+#define MILIA_PROBE3(name, a, b, c) DTRACE_PROBE3(milia, name, a, b, c)
+#else
+#define MILIA_PROBE1(name, a) do {} while (0)
+#define MILIA_PROBE2(name, a, b) do {} while (0)
+#define MILIA_PROBE3(name, a, b, c) do {} while (0)
+#endif
+
+namespace milia
+{
+  namespace detail
+  {
+    // The entry and return probes of the functions with several
+    // return statements, fired by the constructor and the destructor
+
+    class dl_probe
+    {
+      public:
+        dl_probe(double z, std::size_t c) :
+          m_z(z), m_case(c)
+        {
+          MILIA_PROBE2(dl__entry, m_z, m_case);
+        }
+
+        ~dl_probe()
+        {
+          MILIA_PROBE2(dl__return, m_z, m_case);
+        }
+
+      private:
+        double m_z;
+        std::size_t m_case;
+    };
+
+    class age_probe
+    {
+      public:
+        age_probe(double z, std::size_t c) :
+          m_z(z), m_case(c)
+        {
+          MILIA_PROBE2(age__entry, m_z, m_case);
+        }
+
+        ~age_probe()
+        {
+          MILIA_PROBE2(age__return, m_z, m_case);
+        }
+
+      private:
+        double m_z;
+        std::size_t m_case;
+    };
+
+    class dl_array_probe
+    {
+      public:
+        dl_array_probe(std::size_t n, std::size_t c) :
+          m_n(n), m_case(c)
+        {
+          MILIA_PROBE2(dl__array__entry, m_n, m_case);
+        }
+
+        ~dl_array_probe()
+        {
+          MILIA_PROBE2(dl__array__return, m_n, m_case);
+        }
+
+      private:
+        std::size_t m_n;
+        std::size_t m_case;
+    };
+
+    class age_array_probe
+    {
+      public:
+        age_array_probe(std::size_t n, std::size_t c) :
+          m_n(n), m_case(c)
+        {
+          MILIA_PROBE2(age__array__entry, m_n, m_case);
+        }
+
+        ~age_array_probe()
+        {
+          MILIA_PROBE2(age__array__return, m_n, m_case);
+        }
+
+      private:
+        std::size_t m_n;
+        std::size_t m_case;
+    };
+  }
+} // namespace milia
+
+#endif /* MILIA_PROBES_H */
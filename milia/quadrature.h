@@ -0,0 +1,406 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_QUADRATURE_H
+#define MILIA_QUADRATURE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace milia
+{
+  // Numerical integration in [a, inf)
+  // The integrand is a template parameter, a function object with
+  //   double operator()(double x) const
+  // so that its calls are inlined and, in the array version, vectorized.
+  //
+  // The exp-sinh rule of Takahasi and Mori is used: with
+  // x = a + s exp(pi/2 sinh(t)), the trapezoidal rule in t converges
+  // double exponentially when f is analytic and finite in [a, inf) and
+  // decays faster than 1 / x. The step is halved until two levels agree
+  // to the relative tolerance. s = max(1, |a|) is the scale of x - a.
+  //
+  // Finite intervals use the Gauss-Kronrod 7-15 rule with bisection.
+  // The cumulative versions integrate many limits in one pass: the
+  // limits are visited in order and each integral is the previous one
+  // plus the integral over the interval between two consecutive limits.
+  namespace quadrature
+  {
+    namespace detail
+    {
+      // The rule is truncated at |t| = TMAX, exp(pi/2 sinh(TMAX)) ~ 5e30
+      const double TMAX = 4.5;
+      // Step of the first level
+      const double H0 = 0.5;
+      // Maximum number of halvings of the step
+      const int MAXLEVEL = 8;
+      // Width of the blocks in the array version
+      const std::size_t LANES = 16;
+
+      // Abscissa and weight of the rule at t
+      // x = a + s e, dx = s w dt
+      inline void exp_sinh(double t, double& e, double& w)
+      {
+        const double half_pi = 1.57079632679489661923;
+        e = std::exp(half_pi * std::sinh(t));
+        w = half_pi * std::cosh(t) * e;
+      }
+
+      inline double scale(double a)
+      {
+        return std::max(1., std::abs(a));
+      }
+
+      inline bool converged(double res, double prev, double rtol)
+      {
+        return std::abs(res - prev) <= rtol * std::abs(res);
+      }
+
+      // Gauss-Kronrod 7-15 rule in [-1, 1], from QUADPACK (qk15)
+      // Nodes of the Kronrod rule except 0, the odd ones are the
+      // nodes of the Gauss rule
+      const double GK_NODES[7] = { 0.991455371120812639206854697526329,
+          0.949107912342758524526189684047851,
+          0.864864423359769072789712788640926,
+          0.741531185599394439863864773280788,
+          0.586087235467691130294144845693013,
+          0.405845151377397166906606412076961,
+          0.207784955007898467600689403773245 };
+      // Weights of the Kronrod rule, the last one is that of 0
+      const double GK_WEIGHTS[8] = { 0.022935322010529224963732008058970,
+          0.063092092629978553290700663189204,
+          0.104790010322250183839876322541518,
+          0.140653259715525918745189590510238,
+          0.169004726639267902826583426598550,
+          0.190350578064785409913256402421014,
+          0.204432940075298892414161999234649,
+          0.209482141084727828012999174891714 };
+      // Weights of the Gauss rule, the last one is that of 0
+      const double G_WEIGHTS[4] = { 0.129484966168869693270611432679082,
+          0.279705391489276667901467771423780,
+          0.381830050505118944950369775488975,
+          0.417959183673469387755102040816327 };
+      // Maximum number of bisections of an interval
+      const int MAXDEPTH = 40;
+
+      // Kronrod integral in [a, b], err is its difference with
+      // the Gauss integral
+      template<class Function>
+      double gauss_kronrod(const Function& f, double a, double b,
+          double& err)
+      {
+        const double c = 0.5 * (a + b);
+        const double h = 0.5 * (b - a);
+        const double fc = f(c);
+        double k = GK_WEIGHTS[7] * fc;
+        double g = G_WEIGHTS[3] * fc;
+        for (int i = 0; i < 7; ++i)
+        {
+          const double sum = f(c - h * GK_NODES[i]) + f(c + h * GK_NODES[i]);
+          k += GK_WEIGHTS[i] * sum;
+          if (i % 2 == 1)
+            g += G_WEIGHTS[i / 2] * sum;
+        }
+        err = std::abs(h * (k - g));
+        return h * k;
+      }
+
+      // Bisection until the rules agree to the relative tolerance
+      template<class Function>
+      double bisect(const Function& f, double a, double b, double rtol,
+          int depth)
+      {
+        double err;
+        const double res = gauss_kronrod(f, a, b, err);
+        if (err <= rtol * std::abs(res))
+          return res;
+        if (depth == 0)
+          throw std::runtime_error("Integration did not converge");
+        const double c = 0.5 * (a + b);
+        return bisect(f, a, c, rtol, depth - 1) + bisect(f, c, b, rtol, depth
+            - 1);
+      }
+
+      // Orders indices by the values of x
+      struct index_less
+      {
+          const double* x;
+          bool operator()(std::size_t i, std::size_t j) const
+          {
+            return x[i] < x[j];
+          }
+      };
+
+      // Indices of x in increasing order of x, without sorting
+      // if x is already sorted in either direction
+      inline void sort_order(const double* x, std::size_t n,
+          std::vector<std::size_t>& order)
+      {
+        order.resize(n);
+        bool up = true;
+        bool down = true;
+        for (std::size_t i = 0; i + 1 < n; ++i)
+        {
+          up = up && x[i] <= x[i + 1];
+          down = down && x[i] >= x[i + 1];
+        }
+        for (std::size_t i = 0; i < n; ++i)
+          order[i] = down && !up ? n - 1 - i : i;
+        if (!up && !down)
+        {
+          const index_less cmp = { x };
+          std::stable_sort(order.begin(), order.end(), cmp);
+        }
+      }
+
+      // Compensated sum of the integrals of consecutive intervals
+      struct accumulator
+      {
+          double sum;
+          double comp;
+          void add(double v)
+          {
+            const double y = v - comp;
+            const double t = sum + y;
+            comp = (t - sum) - y;
+            sum = t;
+          }
+      };
+    }
+
+    /**
+     * Integral of f in [a, inf)
+     *
+     * @param f integrand
+     * @param a lower limit
+     * @param rtol relative tolerance
+     * @return the integral
+     * @throws std::runtime_error if the tolerance is not reached
+     */
+    template<class Function>
+    double upper(const Function& f, double a, double rtol)
+    {
+      const double s = detail::scale(a);
+      double h = detail::H0;
+      int nk = int(detail::TMAX / h);
+      double sum = 0;
+      for (int k = -nk; k <= nk; ++k)
+      {
+        double e, w;
+        detail::exp_sinh(k * h, e, w);
+        sum += w * f(a + s * e);
+      }
+      double res = s * h * sum;
+      for (int level = 1; level <= detail::MAXLEVEL; ++level)
+      {
+        // Only the new nodes, odd multiples of the step
+        h *= 0.5;
+        nk = int(detail::TMAX / h);
+        sum = 0;
+        for (int k = 1; k <= nk; k += 2)
+        {
+          double e1, w1, e2, w2;
+          detail::exp_sinh(k * h, e1, w1);
+          detail::exp_sinh(-k * h, e2, w2);
+          sum += w1 * f(a + s * e1) + w2 * f(a + s * e2);
+        }
+        const double prev = res;
+        res = 0.5 * prev + s * h * sum;
+        if (detail::converged(res, prev, rtol))
+          return res;
+      }
+      throw std::runtime_error("Integration did not converge");
+    }
+
+    /**
+     * Integrals of f in [a[i], inf) for an array of lower limits
+     *
+     * The nodes and weights are computed once for a block of
+     * limits, the integrand is evaluated over the block.
+     *
+     * @param f integrand
+     * @param a array of lower limits
+     * @param res array where the integrals are stored, may be the same as a
+     * @param n number of elements in a and res
+     * @param rtol relative tolerance
+     * @throws std::runtime_error if the tolerance is not reached
+     */
+    template<class Function>
+    void upper(const Function& f, const double* a, double* res,
+        std::size_t n, double rtol)
+    {
+      const std::size_t LANES = detail::LANES;
+      for (std::size_t i = 0; i < n; i += LANES)
+      {
+        const std::size_t nl = std::min(LANES, n - i);
+        double al[LANES], s[LANES], r[LANES], sum[LANES];
+        for (std::size_t l = 0; l < LANES; ++l)
+        {
+          // unused lanes are padded with the first limit
+          al[l] = l < nl ? a[i + l] : a[i];
+          s[l] = detail::scale(al[l]);
+          sum[l] = 0;
+        }
+        double h = detail::H0;
+        int nk = int(detail::TMAX / h);
+        for (int k = -nk; k <= nk; ++k)
+        {
+          double e, w;
+          detail::exp_sinh(k * h, e, w);
+          for (std::size_t l = 0; l < LANES; ++l)
+            sum[l] += w * f(al[l] + s[l] * e);
+        }
+        for (std::size_t l = 0; l < LANES; ++l)
+          r[l] = s[l] * h * sum[l];
+        bool done = false;
+        for (int level = 1; level <= detail::MAXLEVEL && !done; ++level)
+        {
+          h *= 0.5;
+          nk = int(detail::TMAX / h);
+          std::fill(sum, sum + LANES, 0.);
+          for (int k = 1; k <= nk; k += 2)
+          {
+            double e1, w1, e2, w2;
+            detail::exp_sinh(k * h, e1, w1);
+            detail::exp_sinh(-k * h, e2, w2);
+            for (std::size_t l = 0; l < LANES; ++l)
+              sum[l] += w1 * f(al[l] + s[l] * e1) + w2 * f(al[l] + s[l] * e2);
+          }
+          done = true;
+          for (std::size_t l = 0; l < LANES; ++l)
+          {
+            const double prev = r[l];
+            r[l] = 0.5 * prev + s[l] * h * sum[l];
+            done = done && detail::converged(r[l], prev, rtol);
+          }
+        }
+        if (!done)
+          throw std::runtime_error("Integration did not converge");
+        std::copy(r, r + nl, res + i);
+      }
+    }
+
+    /**
+     * Integral of f in [a, b]
+     *
+     * The Gauss-Kronrod 7-15 rule, with bisection until the Gauss and
+     * Kronrod rules agree to the relative tolerance. b may be lower
+     * than a.
+     *
+     * @param f integrand
+     * @param a lower limit
+     * @param b upper limit
+     * @param rtol relative tolerance
+     * @return the integral
+     * @throws std::runtime_error if the tolerance is not reached
+     */
+    template<class Function>
+    double interval(const Function& f, double a, double b, double rtol)
+    {
+      if (a == b)
+        return 0;
+      // the rules do not agree beyond the rounding errors
+      const double tol = std::max(rtol, 64
+          * std::numeric_limits<double>::epsilon());
+      return detail::bisect(f, a, b, tol, detail::MAXDEPTH);
+    }
+
+    /**
+     * Integrals of f in [x0, x[i]] for an array of upper limits
+     *
+     * The limits are visited in increasing order and the integrals are
+     * accumulated over the intervals between them, so that the cost is
+     * that of one integral over the range of the limits. Limits sorted
+     * in either direction are used as they are, others are sorted
+     * internally; the results are stored in the order of x.
+     *
+     * @param f integrand
+     * @param x0 lower limit
+     * @param x array of upper limits
+     * @param res array where the integrals are stored, may be the same as x
+     * @param n number of elements in x and res
+     * @param rtol relative tolerance of each interval
+     * @throws std::runtime_error if the tolerance is not reached
+     */
+    template<class Function>
+    void cumulative(const Function& f, double x0, const double* x,
+        double* res, std::size_t n, double rtol)
+    {
+      std::vector<std::size_t> order;
+      detail::sort_order(x, n, order);
+      detail::accumulator acc = { 0, 0 };
+      double prev = x0;
+      for (std::size_t k = 0; k < n; ++k)
+      {
+        const std::size_t i = order[k];
+        const double xi = x[i];
+        acc.add(interval(f, prev, xi, rtol));
+        prev = xi;
+        res[i] = acc.sum;
+      }
+    }
+
+    /**
+     * Integrals of f in [a[i], inf) for an array of lower limits,
+     * accumulated along the sorted limits
+     *
+     * The integral from the largest limit is computed with upper, the
+     * others add the integral over the interval to the next larger
+     * limit. Limits sorted in either direction are used as they are,
+     * others are sorted internally; the results are stored in the
+     * order of a.
+     *
+     * @param f integrand
+     * @param a array of lower limits
+     * @param res array where the integrals are stored, may be the same as a
+     * @param n number of elements in a and res
+     * @param rtol relative tolerance
+     * @throws std::runtime_error if the tolerance is not reached
+     */
+    template<class Function>
+    void cumulative_upper(const Function& f, const double* a, double* res,
+        std::size_t n, double rtol)
+    {
+      if (n == 0)
+        return;
+      std::vector<std::size_t> order;
+      detail::sort_order(a, n, order);
+      const double amax = a[order[n - 1]];
+      detail::accumulator acc = { upper(f, amax, rtol), 0 };
+      double prev = amax;
+      for (std::size_t k = n; k-- > 0;)
+      {
+        const std::size_t i = order[k];
+        const double ai = a[i];
+        acc.add(interval(f, ai, prev, rtol));
+        prev = ai;
+        res[i] = acc.sum;
+      }
+    }
+
+  } // namespace quadrature
+
+} // namespace milia
+
+#endif /* MILIA_QUADRATURE_H */
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_QUANTITIES_H
+#define MILIA_QUANTITIES_H
+
+namespace milia
+{
+    /**
+     * Quantities computed by the eval methods of the metrics.
+     * They are bit flags, combined with | to build a mask.
+     */
+    enum quantity
+    {
+      Q_DL = 1 << 0, //!< luminosity distance
+      Q_DA = 1 << 1, //!< angular distance
+      Q_DM = 1 << 2, //!< comoving distance (transverse)
+      Q_DC = 1 << 3, //!< comoving distance (line of sight)
+      Q_VOL = 1 << 4, //!< comoving volume per solid angle
+      Q_AGE = 1 << 5, //!< age of the Universe
+      Q_LT = 1 << 6, //!< look-back time
+      Q_MODULUS = 1 << 7, //!< distance modulus, only in physical units
+      Q_ANGULAR_SCALE = 1 << 8, //!< angular scale, only in physical units
+      Q_ALL = (1 << 9) - 1
+    };
+
+    /**
+     * Values computed by the scalar eval methods.
+     * Only the members requested in the mask are set.
+     */
+    struct quantity_values
+    {
+        double dl;
+        double da;
+        double dm;
+        double dc;
+        double vol;
+        double age;
+        double lt;
+        double modulus;
+        double angular_scale;
+    };
+
+    /**
+     * Output arrays of the array eval methods.
+     * Only the arrays requested in the mask are written, the
+     * others may be null. Initialize with
+     * quantity_columns c = quantity_columns(); to null them all.
+     */
+    struct quantity_columns
+    {
+        double* dl;
+        double* da;
+        double* dm;
+        double* dc;
+        double* vol;
+        double* age;
+        double* lt;
+        double* modulus;
+        double* angular_scale;
+    };
+
+    /**
+     * Constants of the physical units, in long double for flrw_t with
+     * wider types and in double for the rest of the library.
+     * The Hubble radius is in Mpc and the Hubble time in Gyr,
+     * for \f$ H = 1\ km\ s^{-1}\ Mpc^{-1} \f$
+     */
+    const long double HUBBLE_RADIUS_LD = 299792.458L;
+    const long double HUBBLE_TIME_LD = 977.792222L;
+    /// Arc seconds in a radian
+    const long double ARCSEC_PER_RAD_LD = 206264.8062L;
+
+    const double HUBBLE_RADIUS = HUBBLE_RADIUS_LD;
+    const double HUBBLE_TIME = HUBBLE_TIME_LD;
+    const double ARCSEC_PER_RAD = ARCSEC_PER_RAD_LD;
+
+} // namespace milia
+
+#endif /* MILIA_QUANTITIES_H */
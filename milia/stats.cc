@@ -0,0 +1,206 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <pthread.h>
+#include <time.h>
+
+#include "stats_hooks.h"
+
+namespace
+{
+  using milia::stats::counters;
+
+  // Block of one thread, in a list of the live threads
+  struct block
+  {
+      counters c;
+      block* prev;
+      block* next;
+  };
+
+  // The counters are all unsigned long long
+  const std::size_t NVALUES = sizeof(counters) / sizeof(unsigned long long);
+
+  pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+  pthread_once_t g_once = PTHREAD_ONCE_INIT;
+  pthread_key_t g_key;
+  // Live threads, the counts of the finished ones and those at the
+  // last reset, under g_mutex
+  block* g_blocks = 0;
+  counters g_retired = counters();
+  counters g_baseline = counters();
+
+  __thread block* t_block = 0;
+
+  unsigned long long* values(counters& c)
+  {
+    return reinterpret_cast<unsigned long long*> (&c);
+  }
+
+  void accumulate(counters& to, counters& from)
+  {
+    unsigned long long* t = values(to);
+    unsigned long long* f = values(from);
+    for (std::size_t i = 0; i < NVALUES; ++i)
+      t[i] += __atomic_load_n(f + i, __ATOMIC_RELAXED);
+  }
+
+  // At the exit of a thread, its counts are kept in g_retired
+  void retire(void* p)
+  {
+    block* b = static_cast<block*> (p);
+    pthread_mutex_lock(&g_mutex);
+    accumulate(g_retired, b->c);
+    if (b->prev)
+      b->prev->next = b->next;
+    else
+      g_blocks = b->next;
+    if (b->next)
+      b->next->prev = b->prev;
+    pthread_mutex_unlock(&g_mutex);
+    delete b;
+  }
+
+  void create_key()
+  {
+    pthread_key_create(&g_key, retire);
+  }
+
+  // Sum of all the threads, under g_mutex
+  counters total()
+  {
+    counters sum = g_retired;
+    for (block* b = g_blocks; b; b = b->next)
+      accumulate(sum, b->c);
+    return sum;
+  }
+
+  const char* const CASE_NAMES[] = { "OM_OV_0", "OV_1", "OV_2", "OV_EDS",
+      "OM", "OM_DS", "OM_OV_1", "A1", "A2_1", "A2_2" };
+  const char* const KERNEL_NAMES[] = { "dl", "age" };
+  const char* const PATH_NAMES[] = { "A1_eq10", "A1_principal", "A1_node",
+      "vol_series" };
+}
+
+namespace milia
+{
+  namespace stats
+  {
+    namespace detail
+    {
+      int g_flags = 0;
+
+      counters& local()
+      {
+        if (!t_block)
+        {
+          pthread_once(&g_once, create_key);
+          block* b = new block();
+          pthread_mutex_lock(&g_mutex);
+          b->next = g_blocks;
+          if (g_blocks)
+            g_blocks->prev = b;
+          g_blocks = b;
+          pthread_mutex_unlock(&g_mutex);
+          pthread_setspecific(g_key, b);
+          t_block = b;
+        }
+        return t_block->c;
+      }
+
+      unsigned long long now()
+      {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+      }
+    }
+
+    void enable(bool on)
+    {
+      if (on)
+        __atomic_fetch_or(&detail::g_flags, detail::FLAG_COUNT,
+            __ATOMIC_RELAXED);
+      else
+        __atomic_fetch_and(&detail::g_flags, ~detail::FLAG_COUNT,
+            __ATOMIC_RELAXED);
+    }
+
+    bool enabled()
+    {
+      return detail::flags() & detail::FLAG_COUNT;
+    }
+
+    void enable_timing(bool on)
+    {
+      if (on)
+        __atomic_fetch_or(&detail::g_flags, detail::FLAG_TIME,
+            __ATOMIC_RELAXED);
+      else
+        __atomic_fetch_and(&detail::g_flags, ~detail::FLAG_TIME,
+            __ATOMIC_RELAXED);
+    }
+
+    bool timing()
+    {
+      return detail::flags() & detail::FLAG_TIME;
+    }
+
+    counters snapshot()
+    {
+      pthread_mutex_lock(&g_mutex);
+      counters res = total();
+      unsigned long long* r = values(res);
+      const unsigned long long* b = values(g_baseline);
+      for (std::size_t i = 0; i < NVALUES; ++i)
+        r[i] -= b[i];
+      pthread_mutex_unlock(&g_mutex);
+      return res;
+    }
+
+    // The blocks are only written by their threads, the counts
+    // at the reset are subtracted by snapshot
+    void reset()
+    {
+      pthread_mutex_lock(&g_mutex);
+      g_baseline = total();
+      pthread_mutex_unlock(&g_mutex);
+    }
+
+    const char* case_name(std::size_t c)
+    {
+      return c < NCASES ? CASE_NAMES[c] : "";
+    }
+
+    const char* kernel_name(kernel k)
+    {
+      return k < NKERNELS ? KERNEL_NAMES[k] : "";
+    }
+
+    const char* path_name(path p)
+    {
+      return p < NPATHS ? PATH_NAMES[p] : "";
+    }
+  }
+} // namespace milia
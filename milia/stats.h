@@ -0,0 +1,143 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_STATS_H
+#define MILIA_STATS_H
+
+#include <cstddef>
+
+namespace milia
+{
+  /**
+   * Run-time statistics of milia::flrw_nat and milia::flrw.
+   *
+   * The statistics are disabled by default, then each evaluation only
+   * reads a flag. When enabled, each thread counts in its own block with
+   * relaxed atomic stores, and snapshot adds the blocks of all the
+   * threads, including those that have finished.
+   *
+   * The kernels are the luminosity distance, from which the other
+   * distances are computed, and the age, from which the look-back time
+   * is computed. The arrays count one evaluation per element.
+   */
+  namespace stats
+  {
+    /**
+     * Computation cases, in the order of rei::flrw_nat::model
+     */
+    enum
+    {
+      NCASES = 10
+    };
+
+    /**
+     * Kernels
+     */
+    enum kernel
+    {
+      KERNEL_DL, //!< luminosity distance (dl, da, dm, dc and vol)
+      KERNEL_AGE, //!< age (age and lt)
+      NKERNELS
+    };
+
+    /**
+     * Branches inside the computation cases
+     */
+    enum path
+    {
+      PATH_A1_EQ10, //!< age of A1 with equation 10
+      PATH_A1_PRINCIPAL, //!< age of A1 past the node of equation 10
+      PATH_A1_NODE, //!< age of A1 near the node of equation 10
+      PATH_VOL_SERIES, //!< comoving volume of non-flat models by its series
+      NPATHS
+    };
+
+    /**
+     * Counters
+     *
+     * All the members are unsigned long long.
+     */
+    struct counters
+    {
+        //! evaluations of each kernel in each case
+        unsigned long long calls[NCASES][NKERNELS];
+        //! nanoseconds in each kernel in each case, with timing enabled
+        unsigned long long nanoseconds[NCASES][NKERNELS];
+        //! evaluations that took each path
+        unsigned long long paths[NPATHS];
+        //! intervals integrated with the fixed rule near the node of A1
+        unsigned long long intervals;
+    };
+
+    /**
+     * Enables or disables the counters
+     */
+    void enable(bool on);
+
+    /**
+     * True if the counters are enabled
+     */
+    bool enabled();
+
+    /**
+     * Enables or disables the timing of the kernels
+     *
+     * The kernels are timed only when the counters are also enabled.
+     * Each timed evaluation reads the clock twice, tens of nanoseconds.
+     */
+    void enable_timing(bool on);
+
+    /**
+     * True if the timing of the kernels is enabled
+     */
+    bool timing();
+
+    /**
+     * Counts of all the threads since the last reset
+     *
+     * The counts of the evaluations in progress in other threads may be
+     * included or not.
+     */
+    counters snapshot();
+
+    /**
+     * Sets the counts to zero
+     */
+    void reset();
+
+    /**
+     * Name of a computation case, as in rei::flrw_nat::model
+     * @param c the case, lower than NCASES
+     */
+    const char* case_name(std::size_t c);
+
+    /**
+     * Name of a kernel
+     */
+    const char* kernel_name(kernel k);
+
+    /**
+     * Name of a path
+     */
+    const char* path_name(path p);
+  }
+} // namespace milia
+
+#endif /* MILIA_STATS_H */
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_STATS_HOOKS_H
+#define MILIA_STATS_HOOKS_H
+
+// The counting points of milia/stats.h, used by the library sources
+
+#include <cstddef>
+
+#include "stats.h"
+
+namespace milia
+{
+  namespace stats
+  {
+    namespace detail
+    {
+      enum
+      {
+        FLAG_COUNT = 1, FLAG_TIME = 2
+      };
+
+      extern int g_flags;
+
+      inline int flags()
+      {
+        return __atomic_load_n(&g_flags, __ATOMIC_RELAXED);
+      }
+
+      inline bool counting()
+      {
+        return flags() & FLAG_COUNT;
+      }
+
+      // Block of the calling thread, created on first use
+      counters& local();
+
+      // Monotonic clock in nanoseconds
+      unsigned long long now();
+
+      // Only the owner thread writes its block, the others read it
+      inline void add(unsigned long long& c, unsigned long long v)
+      {
+        __atomic_store_n(&c, __atomic_load_n(&c, __ATOMIC_RELAXED) + v,
+            __ATOMIC_RELAXED);
+      }
+
+      inline void count_path(path p, unsigned long long n = 1)
+      {
+        if (counting() && n > 0)
+          add(local().paths[p], n);
+      }
+
+      // Counts the n evaluations of a kernel in its scope, and
+      // times them if enabled
+      class kernel_scope
+      {
+        public:
+          kernel_scope(std::size_t c, kernel k, std::size_t n) :
+            m_block(0)
+          {
+            const int f = flags();
+            // the metrics without a case are not counted
+            if (!(f & FLAG_COUNT) || c >= NCASES)
+              return;
+            m_block = &local();
+            m_case = c;
+            m_kernel = k;
+            add(m_block->calls[c][k], n);
+            m_start = (f & FLAG_TIME) ? now() : 0;
+          }
+
+          ~kernel_scope()
+          {
+            if (m_block && m_start)
+              add(m_block->nanoseconds[m_case][m_kernel], now() - m_start);
+          }
+
+        private:
+          kernel_scope(const kernel_scope&);
+          kernel_scope& operator=(const kernel_scope&);
+
+          counters* m_block;
+          std::size_t m_case;
+          kernel m_kernel;
+          unsigned long long m_start;
+      };
+    }
+  }
+} // namespace milia
+
+#endif /* MILIA_STATS_HOOKS_H */
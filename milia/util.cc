@@ -31,11 +31,24 @@
 
 #include "flrw_nat.h"
 #include "flrw_prec.h"
+#include "util.h"
 
 using std::abs;
 using boost::math::asinh;
 using boost::math::pow;
 
+namespace
+{
+  // Gauss-Legendre rule of 8 points, nodes in [0, 1] and weights
+  const int GL_POINTS = 4;
+  const double GL_NODES[GL_POINTS] = { 0.1834346424956498049394761,
+      0.5255324099163289858177390, 0.7966664774136267395915539,
+      0.9602898564975362316835609 };
+  const double GL_WEIGHTS[GL_POINTS] = { 0.3626837833783619829651504,
+      0.3137066458778872873379622, 0.2223810344533744705443560,
+      0.1012285362903762591525314 };
+}
+
 namespace milia
 {
     double sinc(int k, double a, double x)
@@ -66,4 +79,16 @@ namespace milia
         }
     }
 
+    double age_interval(double om, double ov, double z0, double z1)
+    {
+      const age_integrand f = { om, ov };
+      const double c = 0.5 * (z0 + z1);
+      const double h = 0.5 * (z1 - z0);
+      double sum = 0;
+      for (int i = 0; i < GL_POINTS; ++i)
+        sum += GL_WEIGHTS[i] * (f(c - h * GL_NODES[i]) + f(c + h
+            * GL_NODES[i]));
+      return h * sum;
+    }
+
 } //namespace milia
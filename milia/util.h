@@ -18,14 +18,38 @@
  *
  */
 
+#ifndef MILIA_UTIL_H
+#define MILIA_UTIL_H
+
 #ifdef HAVE_CONFIG_H
 #include <config.h>
 #endif
 
+#include <cmath>
+
 namespace milia
 {
     double sinc(int k, double a, double x);
 
     double asinc(int k, double a, double x);
 
+    // Integrand of the age, 1 / ((1 + z) E(z))
+    struct age_integrand
+    {
+        double om;
+        double ov;
+
+        double operator()(double z) const
+        {
+          return 1. / ((1 + z) * std::sqrt((1 + z) * (1 + z) * (1 + om * z)
+              - z * ov * (2 + z)));
+        }
+    };
+
+    // Integral of the age, 1 / ((1 + z) E(z)), between z0 and z1
+    // Fixed Gauss-Legendre rule, only for short intervals
+    double age_interval(double om, double ov, double z0, double z1);
+
 } //namespace milia
+
+#endif /* MILIA_UTIL_H */
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_VMATH_H
+#define MILIA_VMATH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
+
+namespace milia
+{
+  // Elementary functions for the loops of the array versions
+  // They are inline and have no branches, the compiler can vectorize
+  // the loops that call them (libm calls prevent it).
+  // Valid for finite arguments in the domain of each function,
+  // accurate to a few ulp. Subnormals, infinities and NaNs are not
+  // handled specially.
+  namespace vmath
+  {
+    namespace detail
+    {
+      inline boost::uint64_t to_bits(double x)
+      {
+        boost::uint64_t u;
+        std::memcpy(&u, &x, sizeof(u));
+        return u;
+      }
+
+      inline double from_bits(boost::uint64_t u)
+      {
+        double x;
+        std::memcpy(&x, &u, sizeof(x));
+        return x;
+      }
+
+      // atan(u) for |u| <= tan(pi / 16), Taylor series
+      inline double atan_kernel(double u)
+      {
+        const double u2 = u * u;
+        double p = -1. / 29;
+        p = 1. / 27 + u2 * p;
+        p = -1. / 25 + u2 * p;
+        p = 1. / 23 + u2 * p;
+        p = -1. / 21 + u2 * p;
+        p = 1. / 19 + u2 * p;
+        p = -1. / 17 + u2 * p;
+        p = 1. / 15 + u2 * p;
+        p = -1. / 13 + u2 * p;
+        p = 1. / 11 + u2 * p;
+        p = -1. / 9 + u2 * p;
+        p = 1. / 7 + u2 * p;
+        p = -1. / 5 + u2 * p;
+        p = 1. / 3 + u2 * p;
+        return u - u * u2 * p;
+      }
+    }
+
+    // Natural logarithm, x > 0
+    // Reduction and polynomial from fdlibm's e_log.c
+    inline double log(double x)
+    {
+      const double ln2_hi = 6.93147180369123816490e-01;
+      const double ln2_lo = 1.90821492927058770002e-10;
+      const double Lg1 = 6.666666666666735130e-01;
+      const double Lg2 = 3.999999999940941908e-01;
+      const double Lg3 = 2.857142874366239149e-01;
+      const double Lg4 = 2.222219843214978396e-01;
+      const double Lg5 = 1.818357216161805012e-01;
+      const double Lg6 = 1.531383769920937332e-01;
+      const double Lg7 = 1.479819860511658591e-01;
+
+      // x = 2^k m, with sqrt(2) / 2 <= m < sqrt(2)
+      const boost::uint64_t ix = detail::to_bits(x);
+      const boost::uint64_t hx = (ix >> 32) + (0x3ff00000 - 0x3fe6a09e);
+      const double dk = static_cast<int> (hx >> 20) - 0x3ff;
+      const boost::uint64_t im = (((hx & 0x000fffff) + 0x3fe6a09e) << 32)
+          | (ix & 0xffffffff);
+      const double f = detail::from_bits(im) - 1;
+
+      const double hfsq = 0.5 * f * f;
+      const double s = f / (2 + f);
+      const double z = s * s;
+      const double w = z * z;
+      const double t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+      const double t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+      return s * (hfsq + t1 + t2) + dk * ln2_lo - hfsq + f + dk * ln2_hi;
+    }
+
+    // log(1 + x), x > -1
+    inline double log1p(double x)
+    {
+      const double w = 1 + x;
+      // correction for the rounding of 1 + x
+      return log(w) + (x - (w - 1)) / w;
+    }
+
+    // Inverse hyperbolic tangent, |x| < 1
+    inline double atanh(double x)
+    {
+      const double a = std::abs(x);
+      const double r = 0.5 * log1p(2 * a / (1 - a));
+      return x < 0 ? -r : r;
+    }
+
+    // Inverse hyperbolic sine, |x| < 1e150
+    inline double asinh(double x)
+    {
+      const double a = std::abs(x);
+      const double r = log1p(a + a * (a / (1 + std::sqrt(1 + a * a))));
+      return x < 0 ? -r : r;
+    }
+
+    // Inverse tangent
+    inline double atan(double x)
+    {
+      const double pi_2 = 1.57079632679489661923;
+      const double a = std::abs(x);
+      // atan(a) = pi / 2 - atan(1 / a)
+      double t = std::min(a, 1 / a);
+      // atan(t) = 2 atan(t / (1 + sqrt(1 + t^2))), applied twice
+      t = t / (1 + std::sqrt(1 + t * t));
+      t = t / (1 + std::sqrt(1 + t * t));
+      // the selection is arithmetic, a conditional would be
+      // turned into a branch
+      const double inv = a > 1 ? 1 : 0;
+      const double r = inv * pi_2 + (1 - 2 * inv) * (4
+          * detail::atan_kernel(t));
+      return x < 0 ? -r : r;
+    }
+
+    // Inverse sine, |x| <= 1
+    inline double asin(double x)
+    {
+      return atan(x / std::sqrt((1 - x) * (1 + x)));
+    }
+
+    // Inverse cosine, |x| <= 1
+    inline double acos(double x)
+    {
+      return 2 * atan(std::sqrt((1 - x) / (1 + x)));
+    }
+
+  } // namespace vmath
+} //namespace milia
+
+#endif /* MILIA_VMATH_H */
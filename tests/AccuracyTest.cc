@@ -0,0 +1,148 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AccuracyTest.h"
+#include "milia/flrw_nat.h"
+#include "milia/metric.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  // One cosmology of each case, flat models near the ends and closed
+  // models with vacuum > 1
+  const double MATTER[] = { 0, 0.3, 2, 1, 0, 0, 0.3, 0.3, 0.3, 3, 0.05, 0.9,
+      0.1, 0.3, 0.025, 0.077 };
+  const double VACUUM[] = { 0, 0, 0, 0, 0.5, 1, 0.7, 0.2, 0.8, 0.1, 0.95,
+      0.1, 1.1, 1.2, 1.045, 1.03 };
+  const std::size_t NCOSMO = sizeof(MATTER) / sizeof(MATTER[0]);
+
+  // At lower z the differences of elliptic integrals cancel
+  // with all the policies
+  const double Z[] = { 1e-3, 0.01, 0.1, 0.5, 1, 2.5, 6, 30, 100, 1100 };
+  const std::size_t NZ = sizeof(Z) / sizeof(Z[0]);
+
+  void assert_rel(double expected, double actual, double rtol)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, rtol * std::abs(expected));
+  }
+
+  // Scalar and array methods of a policy against ACCURACY_REFERENCE
+  void check(milia::accuracy acc, double rtol)
+  {
+    const std::vector<double> z(Z, Z + NZ);
+    std::vector<double> dl(NZ), age(NZ), vol(NZ), zinv(NZ);
+    for (std::size_t c = 0; c < NCOSMO; ++c)
+    {
+      const milia::flrw_nat ref(MATTER[c], VACUUM[c]);
+      milia::flrw_nat nat(MATTER[c], VACUUM[c]);
+      nat.set_accuracy(acc);
+      CPPUNIT_ASSERT_EQUAL(acc, nat.get_accuracy());
+      // de Sitter has no age
+      const bool has_age = MATTER[c] != 0 || VACUUM[c] != 1;
+
+      nat.dl(&z[0], &dl[0], NZ);
+      nat.vol(&z[0], &vol[0], NZ);
+      if (has_age)
+        nat.age(&z[0], &age[0], NZ);
+      for (std::size_t j = 0; j < NZ; ++j)
+      {
+        const double rdl = ref.dl(z[j]);
+        assert_rel(rdl, nat.dl(z[j]), rtol);
+        assert_rel(rdl, dl[j], rtol);
+        assert_rel(ref.vol(z[j]), nat.vol(z[j]), rtol);
+        assert_rel(ref.vol(z[j]), vol[j], rtol);
+        assert_rel(ref.lt(z[j]), nat.lt(z[j]), rtol);
+        if (has_age)
+        {
+          assert_rel(ref.age(z[j]), nat.age(z[j]), rtol);
+          assert_rel(ref.age(z[j]), age[j], rtol);
+        }
+        assert_rel(z[j], nat.z_from_dl(rdl), rtol);
+        dl[j] = rdl;
+      }
+      nat.z_from_dl(&dl[0], &zinv[0], NZ);
+      for (std::size_t j = 0; j < NZ; ++j)
+        assert_rel(z[j], zinv[j], rtol);
+    }
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(AccuracyTest);
+
+void AccuracyTest::setUp()
+{
+}
+
+void AccuracyTest::tearDown()
+{
+}
+
+void AccuracyTest::testDefault()
+{
+  const milia::flrw_nat nat(0.3, 0.7);
+  CPPUNIT_ASSERT_EQUAL(milia::ACCURACY_REFERENCE, nat.get_accuracy());
+  const milia::flrw metric(70, 0.3, 0.7);
+  CPPUNIT_ASSERT_EQUAL(milia::ACCURACY_REFERENCE, metric.get_accuracy());
+}
+
+void AccuracyTest::testKept()
+{
+  milia::flrw_nat nat(0.3, 0.7);
+  nat.set_accuracy(milia::ACCURACY_FAST);
+  const milia::flrw_nat copy(nat);
+  CPPUNIT_ASSERT_EQUAL(milia::ACCURACY_FAST, copy.get_accuracy());
+  CPPUNIT_ASSERT_EQUAL(nat.dl(1.2), copy.dl(1.2));
+
+  // The invariants are recomputed with the policy
+  nat.set_parameters(0.3, 0.2);
+  CPPUNIT_ASSERT_EQUAL(milia::ACCURACY_FAST, nat.get_accuracy());
+  milia::flrw_nat other(0.3, 0.2);
+  other.set_accuracy(milia::ACCURACY_FAST);
+  CPPUNIT_ASSERT_EQUAL(other.dl(1.2), nat.dl(1.2));
+  CPPUNIT_ASSERT_EQUAL(other.age(), nat.age());
+
+  nat.set_matter(0.25);
+  nat.set_vacuum(0.75);
+  CPPUNIT_ASSERT_EQUAL(milia::ACCURACY_FAST, nat.get_accuracy());
+
+  milia::flrw metric(70, 0.3, 0.7);
+  metric.set_accuracy(milia::ACCURACY_STANDARD);
+  metric.set_parameters(0.25, 0.75, 72);
+  CPPUNIT_ASSERT_EQUAL(milia::ACCURACY_STANDARD, metric.get_accuracy());
+
+  // Back to the default, the results are those of a new object
+  nat.set_accuracy(milia::ACCURACY_REFERENCE);
+  const milia::flrw_nat ref(0.25, 0.75);
+  CPPUNIT_ASSERT_EQUAL(ref.dl(1.2), nat.dl(1.2));
+  CPPUNIT_ASSERT_EQUAL(ref.age(), nat.age());
+}
+
+void AccuracyTest::testFast()
+{
+  check(milia::ACCURACY_FAST, 1e-6);
+}
+
+void AccuracyTest::testStandard()
+{
+  check(milia::ACCURACY_STANDARD, 1e-10);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_ACCURACY_TEST_H
+#define MILIA_ACCURACY_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class AccuracyTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(AccuracyTest);
+    CPPUNIT_TEST(testDefault);
+    CPPUNIT_TEST(testKept);
+    CPPUNIT_TEST(testFast);
+    CPPUNIT_TEST(testStandard);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks that the default policy is ACCURACY_REFERENCE */
+    void testDefault();
+
+    /** Checks that the policy is kept by copies and by the setters */
+    void testKept();
+
+    /** Checks ACCURACY_FAST against ACCURACY_REFERENCE */
+    void testFast();
+
+    /** Checks ACCURACY_STANDARD against ACCURACY_REFERENCE */
+    void testStandard();
+};
+
+#endif // MILIA_ACCURACY_TEST_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ClosedFormTest.h"
+#include "milia/closed_form.h"
+#include "milia/flrw_nat.h"
+
+#include <cmath>
+
+namespace
+{
+  const double RTOL = 1.0e-14;
+
+  void assert_close(double expected, double actual)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, RTOL * (1 + std::abs(
+        expected)));
+  }
+
+  namespace cf = milia::closed_form;
+
+  // Initialized at compile time if the functions are constexpr
+#if MILIA_HAS_CONSTEXPR
+  constexpr
+#else
+  const
+#endif
+  double EDS_DL[] = { cf::eds_dl(0.), cf::eds_dl(0.5), cf::eds_dl(1.),
+      cf::eds_dl(3.) };
+  const double Z[] = { 0, 0.5, 1, 3 };
+
+#if MILIA_HAS_CONSTEXPR
+  static_assert(cf::empty_dl(2.) == 4, "closed forms are not constexpr");
+#endif
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ClosedFormTest);
+
+void ClosedFormTest::setUp()
+{
+}
+
+void ClosedFormTest::tearDown()
+{
+}
+
+void ClosedFormTest::testValues()
+{
+  assert_close(4, cf::empty_dl(2.));
+  assert_close(0.25, cf::empty_age(3.));
+  assert_close(4, cf::eds_dl(3.));
+  assert_close(1. / 12, cf::eds_age(3.));
+  assert_close(2, cf::de_sitter_dl(1.));
+  assert_close(std::log(2.), cf::de_sitter_lt(1.));
+  // matter only with matter 1 is Einstein-de Sitter
+  for (double z = 0; z < 10; z += 0.7)
+    assert_close(cf::eds_dl(z), cf::matter_dl(1., z));
+}
+
+void ClosedFormTest::testFlrwNat()
+{
+  const double matter[] = { 0.3, 2, 0, 0.25 };
+  const double vacuum[] = { 0, 0, 0.6, 0.75 };
+  for (double z = 0.05; z < 20; z *= 1.9)
+  {
+    const milia::flrw_nat open(matter[0], vacuum[0]);
+    assert_close(open.dl(z), cf::matter_dl(matter[0], z));
+    assert_close(open.age(z), cf::open_matter_age(matter[0], z));
+    const milia::flrw_nat closed(matter[1], vacuum[1]);
+    assert_close(closed.dl(z), cf::matter_dl(matter[1], z));
+    assert_close(closed.age(z), cf::closed_matter_age(matter[1], z));
+    const milia::flrw_nat vac(matter[2], vacuum[2]);
+    assert_close(vac.dl(z), cf::vacuum_dl(vacuum[2], z));
+    assert_close(vac.age(z), cf::vacuum_age(vacuum[2], z));
+    const milia::flrw_nat flat(matter[3], vacuum[3]);
+    assert_close(flat.age(z), cf::flat_age(matter[3], z));
+  }
+}
+
+void ClosedFormTest::testTable()
+{
+  const milia::flrw_nat eds(1, 0);
+  for (std::size_t i = 0; i < sizeof(Z) / sizeof(Z[0]); ++i)
+    assert_close(eds.dl(Z[i]), EDS_DL[i]);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_CLOSED_FORM_TEST_H
+#define MILIA_CLOSED_FORM_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ClosedFormTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ClosedFormTest);
+    CPPUNIT_TEST(testValues);
+    CPPUNIT_TEST(testFlrwNat);
+    CPPUNIT_TEST(testTable);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks values known exactly */
+    void testValues();
+
+    /** Checks the closed forms against flrw_nat */
+    void testFlrwNat();
+
+    /** Checks a table of values initialized from the closed forms */
+    void testTable();
+};
+
+#endif // MILIA_CLOSED_FORM_TEST_H
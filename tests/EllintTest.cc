@@ -0,0 +1,169 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "EllintTest.h"
+#include "milia/ellint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <boost/math/special_functions/ellint_1.hpp>
+#include <boost/math/special_functions/ellint_3.hpp>
+#include <boost/math/special_functions/ellint_rf.hpp>
+#include <boost/math/special_functions/ellint_rj.hpp>
+
+namespace
+{
+  const double RTOL = 1.0e-13;
+  // Principal values lose some digits near the pole
+  const double PVTOL = 1.0e-11;
+
+  void assert_close(double expected, double actual, double tol)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, tol * (1 + std::abs(
+        expected)));
+  }
+
+  // Amplitudes in [0, 2 pi]
+  std::vector<double> amplitudes()
+  {
+    std::vector<double> phi;
+    for (double p = 0; p < 6.28; p += 0.0371)
+      phi.push_back(p);
+    return phi;
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(EllintTest);
+
+void EllintTest::setUp()
+{
+}
+
+void EllintTest::tearDown()
+{
+}
+
+void EllintTest::testCarlson()
+{
+  for (double x = 0; x < 3; x += 0.31)
+    for (double y = 0.05; y < 3; y += 0.29)
+    {
+      assert_close(boost::math::ellint_rf(x, y, 1.3), milia::ellint_rf(x, y,
+          1.3), RTOL);
+      for (double p = 0.07; p < 4; p += 0.53)
+        assert_close(boost::math::ellint_rj(x, y, 1.3, p), milia::ellint_rj(x,
+            y, 1.3, p), RTOL);
+      for (double p = -4; p < -0.01; p += 0.53)
+        assert_close(boost::math::ellint_rj(x, y, 1.3, p), milia::ellint_rj(x,
+            y, 1.3, p), PVTOL);
+    }
+  // y << x, near the logarithmic singularity of the principal values
+  for (double y = 1e-12; y < 3; y *= 7)
+  {
+    assert_close(boost::math::ellint_rc(1.3, y), milia::ellint_rc(1.3, y),
+        RTOL);
+    assert_close(boost::math::ellint_rc(1.3, -y), milia::ellint_rc(1.3, -y),
+        RTOL);
+  }
+}
+
+void EllintTest::testFirstKind()
+{
+  const std::vector<double> phi = amplitudes();
+  for (double k = 0; k < 1; k += 0.0497)
+    for (std::size_t i = 0; i < phi.size(); ++i)
+      assert_close(boost::math::ellint_1(k, phi[i]), milia::ellint_f(k,
+          phi[i]), RTOL);
+}
+
+void EllintTest::testThirdKind()
+{
+  const std::vector<double> phi = amplitudes();
+  for (double k = 0; k < 1; k += 0.0497)
+    for (double n = -3; n < 0.99; n += 0.173)
+      for (std::size_t i = 0; i < phi.size(); ++i)
+      {
+        // boost only handles n > 0 for amplitudes up to pi / 2
+        if (n > 0 && phi[i] > 1.57)
+          continue;
+        assert_close(boost::math::ellint_3(k, n, phi[i]), milia::ellint_pi(k,
+            n, phi[i]), RTOL);
+      }
+}
+
+void EllintTest::testArrays()
+{
+  // The size is not a multiple of the block width
+  const std::vector<double> phi = amplitudes();
+  std::vector<double> res(phi.size());
+  for (double k = 0; k < 1; k += 0.0997)
+  {
+    milia::ellint_f(k, &phi[0], &res[0], phi.size());
+    for (std::size_t i = 0; i < phi.size(); ++i)
+      assert_close(milia::ellint_f(k, phi[i]), res[i], RTOL);
+
+    // In place
+    std::vector<double> tmp(phi);
+    milia::ellint_f(k, &tmp[0], &tmp[0], tmp.size());
+    for (std::size_t i = 0; i < phi.size(); ++i)
+      assert_close(res[i], tmp[i], RTOL);
+
+    // Some lanes need principal values with n > 1
+    for (double n = -2; n < 3; n += 0.61)
+    {
+      milia::ellint_pi(k, n, &phi[0], &res[0], phi.size());
+      for (std::size_t i = 0; i < phi.size(); ++i)
+        assert_close(milia::ellint_pi(k, n, phi[i]), res[i], RTOL);
+    }
+  }
+}
+
+void EllintTest::testTolerance()
+{
+  const std::vector<double> phi = amplitudes();
+  std::vector<double> res(phi.size());
+  for (double rtol = 1e-12; rtol < 1e-5; rtol *= 100)
+    for (double k = 0; k < 1; k += 0.0997)
+    {
+      milia::ellint_f(k, &phi[0], &res[0], phi.size(), rtol);
+      for (std::size_t i = 0; i < phi.size(); ++i)
+      {
+        const double f = milia::ellint_f(k, phi[i]);
+        assert_close(f, milia::ellint_f(k, phi[i], rtol), rtol);
+        assert_close(f, res[i], rtol);
+      }
+      for (double n = -2; n < 3; n += 0.61)
+      {
+        milia::ellint_pi(k, n, &phi[0], &res[0], phi.size(), rtol);
+        for (std::size_t i = 0; i < phi.size(); ++i)
+        {
+          const double p = milia::ellint_pi(k, n, phi[i]);
+          // Pi is a sum of RF and RJ, and loses a digit in the
+          // principal values
+          const double tol = std::max(20 * rtol, PVTOL);
+          assert_close(p, milia::ellint_pi(k, n, phi[i], rtol), tol);
+          assert_close(p, res[i], tol);
+        }
+      }
+    }
+}
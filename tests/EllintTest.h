@@ -0,0 +1,56 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_ELLINT_TEST_H
+#define MILIA_ELLINT_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class EllintTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(EllintTest);
+    CPPUNIT_TEST(testCarlson);
+    CPPUNIT_TEST(testFirstKind);
+    CPPUNIT_TEST(testThirdKind);
+    CPPUNIT_TEST(testArrays);
+    CPPUNIT_TEST(testTolerance);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks RF and RJ against boost, including the principal value of RJ */
+    void testCarlson();
+
+    /** Checks F against boost::math::ellint_1 */
+    void testFirstKind();
+
+    /** Checks Pi against boost::math::ellint_3 */
+    void testThirdKind();
+
+    /** Checks the array versions against the scalar ones */
+    void testArrays();
+
+    /** Checks the integrals computed with a relative tolerance */
+    void testTolerance();
+};
+
+#endif // MILIA_ELLINT_TEST_H
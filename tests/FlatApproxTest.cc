@@ -0,0 +1,121 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FlatApproxTest.h"
+#include "milia/flrw_t.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Documented bound of the relative error, in
+  // milia/flatmodel.h and milia/flrw_t.h
+  const double BOUND = 1.0e-6;
+
+  // The exact model is accurate to 1e-14
+  void assert_bound(double expected, double actual)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, BOUND * std::abs(expected));
+  }
+
+  // z in [0, 1100], denser at low z where the series and the
+  // fits meet
+  std::vector<double> redshifts()
+  {
+    std::vector<double> z(1, 0.);
+    for (double lz = -6; lz < 3.0414; lz += 0.0173)
+      z.push_back(std::pow(10., lz));
+    for (double x = 0.15; x < 0.25; x += 0.0013)
+      z.push_back(x);
+    z.push_back(1100);
+    return z;
+  }
+
+  typedef milia::flrw_t<milia::model::flat_lcdm> exact_flrw;
+  typedef milia::flrw_t<milia::model::flat_lcdm_approx> approx_flrw;
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FlatApproxTest);
+
+void FlatApproxTest::setUp()
+{
+}
+
+void FlatApproxTest::tearDown()
+{
+}
+
+void FlatApproxTest::testBound()
+{
+  const std::vector<double> z = redshifts();
+  // matter in [0.05, 1], with s = 1 at matter = 0.5
+  for (double om = 0.05; om < 1; om += 0.0119)
+  {
+    const milia::impl::flrw_nat_OM_OV_1 exact(om);
+    const milia::impl::flrw_nat_OM_OV_1_approx approx(om);
+    for (std::size_t i = 0; i < z.size(); ++i)
+    {
+      assert_bound(exact.dl(z[i]), approx.dl(z[i]));
+      assert_bound(exact.age(z[i]), approx.age(z[i]));
+    }
+  }
+  const double ends[] = { 0.05, 0.5, 1 - 1e-12 };
+  for (std::size_t m = 0; m < 3; ++m)
+  {
+    const milia::impl::flrw_nat_OM_OV_1 exact(ends[m]);
+    const milia::impl::flrw_nat_OM_OV_1_approx approx(ends[m]);
+    for (std::size_t i = 0; i < z.size(); ++i)
+      assert_bound(exact.dl(z[i]), approx.dl(z[i]));
+  }
+}
+
+void FlatApproxTest::testFlrwT()
+{
+  const std::vector<double> z = redshifts();
+  const exact_flrw exact(70, 0.3, 0.7);
+  const approx_flrw approx(70, 0.3, 0.7);
+  CPPUNIT_ASSERT_EQUAL(std::string(exact.model()), std::string(
+      approx.model()));
+  std::vector<double> res(z.size());
+  approx.dl(&z[0], &res[0], z.size());
+  for (std::size_t i = 0; i < z.size(); ++i)
+  {
+    assert_bound(exact.dl(z[i]), approx.dl(z[i]));
+    assert_bound(exact.dl(z[i]), res[i]);
+    assert_bound(exact.dc(z[i]), approx.dc(z[i]));
+    // the volume is the cube of a distance
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.vol(z[i]), approx.vol(z[i]), 3
+        * BOUND * exact.vol(z[i]));
+    assert_bound(exact.age(z[i]), approx.age(z[i]));
+    assert_bound(exact.lt(z[i]), approx.lt(z[i]));
+
+    milia::quantity_values v;
+    approx.eval(z[i], milia::Q_DL | milia::Q_AGE, v);
+    CPPUNIT_ASSERT_EQUAL(approx.dl(z[i]), v.dl);
+    CPPUNIT_ASSERT_EQUAL(approx.age(z[i]), v.age);
+  }
+}
+
+void FlatApproxTest::testCaseThrows()
+{
+  const approx_flrw c(70, 0.3, 0.3);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_FLAT_APPROX_TEST_H
+#define MILIA_FLAT_APPROX_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <stdexcept>
+
+class FlatApproxTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(FlatApproxTest);
+    CPPUNIT_TEST(testBound);
+    CPPUNIT_TEST(testFlrwT);
+    CPPUNIT_TEST_EXCEPTION(testCaseThrows, std::domain_error);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks the error bound of the approximate flat model */
+    void testBound();
+
+    /** Checks flrw_t<model::flat_lcdm_approx> against flat_lcdm */
+    void testFlrwT();
+
+    /** Checks that non flat densities throw */
+    void testCaseThrows();
+};
+
+#endif // MILIA_FLAT_APPROX_TEST_H
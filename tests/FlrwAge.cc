@@ -115,3 +115,28 @@ void FlrwAge::testAge()
       }
     }
 }
+
+void FlrwAge::testAgeClosed()
+{
+  const double z[] = { 0, 0.5, 2, 8 };
+  for (double om = 0.05; om < 3; om += 0.1)
+    for (double ol = 0.6; ol < 3; ol += 0.1)
+    {
+      try
+      {
+        const milia::flrw_nat m(om, ol);
+        for (int i = 0; i < 4; ++i)
+        {
+          const double iv = integrate_time(z[i], om, ol);
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(iv, m.age(z[i]), ITOL * iv);
+        }
+      } catch (std::domain_error& e)
+      {
+      }
+    }
+  // At the node of eq 10, 1 - n10 sin^2(phi) ~ 1e-16
+  const milia::flrw_nat m(0.3, 1.71);
+  const double zn = 7.9860105158918291;
+  const double iv = integrate_time(zn, 0.3, 1.71);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(iv, m.age(zn), ITOL * iv);
+}
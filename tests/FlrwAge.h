@@ -27,6 +27,7 @@ class FlrwAge : public CppUnit::TestFixture
 {
     CPPUNIT_TEST_SUITE(FlrwAge);
     CPPUNIT_TEST(testAge);
+    CPPUNIT_TEST(testAgeClosed);
     CPPUNIT_TEST_SUITE_END();
 public:
     void setUp();
@@ -35,6 +36,9 @@ public:
 
     /** Checks the age is OK */
     void testAge();
+
+    /** Checks the age of closed models, at both sides of the node of eq 10 */
+    void testAgeClosed();
 };
 
 
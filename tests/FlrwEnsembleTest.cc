@@ -0,0 +1,185 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FlrwEnsembleTest.h"
+#include "milia/flrw_ensemble.h"
+#include "milia/metric.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  const double RTOL = 1.0e-12;
+
+  void assert_close(double expected, double actual)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, RTOL * (1 + std::abs(
+        expected)));
+  }
+
+  // Flat and non flat models interleaved, some differ only in H0
+  const double HUBBLE[] = { 70, 70, 65, 72, 70, 60, 70, 70, 73, 70, 70, 70,
+      68, 70 };
+  const double MATTER[] = { 0.3, 0.3, 0.3, 0.25, 0.3, 0.3, 1, 0, 0.5, 2, 0,
+      0, 0.25, 0.3 };
+  const double VACUUM[] = { 0.7, 0.2, 0.7, 0.75, 0.8, 0.2, 0, 1, 0.5, 0, 0.5,
+      0, 0.75, 0 };
+  const std::size_t NCOSMO = sizeof(HUBBLE) / sizeof(HUBBLE[0]);
+
+  // z = 0 is excluded, the modulus is -inf
+  std::vector<double> redshifts()
+  {
+    std::vector<double> z;
+    for (double x = 0.01; x < 5; x += 0.137)
+      z.push_back(x);
+    return z;
+  }
+
+  milia::flrw_ensemble ensemble()
+  {
+    return milia::flrw_ensemble(HUBBLE, MATTER, VACUUM, NCOSMO);
+  }
+
+  typedef void (milia::flrw::*flrw_method)(const double*, double*,
+      std::size_t) const;
+  typedef void (milia::flrw_ensemble::*ensemble_method)(const double*,
+      double*, std::size_t) const;
+
+  void check(flrw_method fm, ensemble_method em)
+  {
+    const milia::flrw_ensemble ens = ensemble();
+    const std::vector<double> z = redshifts();
+    const std::size_t nz = z.size();
+    std::vector<double> res(NCOSMO * nz), ref(nz);
+    (ens.*em)(&z[0], &res[0], nz);
+    for (std::size_t i = 0; i < NCOSMO; ++i)
+    {
+      const milia::flrw metric(HUBBLE[i], MATTER[i], VACUUM[i]);
+      (metric.*fm)(&z[0], &ref[0], nz);
+      for (std::size_t j = 0; j < nz; ++j)
+        assert_close(ref[j], res[i * nz + j]);
+    }
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(FlrwEnsembleTest);
+
+void FlrwEnsembleTest::setUp()
+{
+}
+
+void FlrwEnsembleTest::tearDown()
+{
+}
+
+void FlrwEnsembleTest::testModels()
+{
+  const milia::flrw_ensemble ens = ensemble();
+  CPPUNIT_ASSERT_EQUAL(NCOSMO, ens.size());
+  // (0.3, 0.7), (0.3, 0.2) and (0.25, 0.75) are repeated
+  CPPUNIT_ASSERT_EQUAL(NCOSMO - 3, ens.models());
+  for (std::size_t i = 0; i < NCOSMO; ++i)
+  {
+    CPPUNIT_ASSERT_EQUAL(HUBBLE[i], ens.get_hubble(i));
+    CPPUNIT_ASSERT_EQUAL(MATTER[i], ens.get_matter(i));
+    CPPUNIT_ASSERT_EQUAL(VACUUM[i], ens.get_vacuum(i));
+  }
+}
+
+void FlrwEnsembleTest::testMethods()
+{
+  check(&milia::flrw::dc, &milia::flrw_ensemble::dc);
+  check(&milia::flrw::dm, &milia::flrw_ensemble::dm);
+  check(&milia::flrw::da, &milia::flrw_ensemble::da);
+  check(&milia::flrw::dl, &milia::flrw_ensemble::dl);
+  check(&milia::flrw::DM, &milia::flrw_ensemble::DM);
+  check(&milia::flrw::vol, &milia::flrw_ensemble::vol);
+  check(&milia::flrw::age, &milia::flrw_ensemble::age);
+  check(&milia::flrw::lt, &milia::flrw_ensemble::lt);
+}
+
+void FlrwEnsembleTest::testEval()
+{
+  const milia::flrw_ensemble ens = ensemble();
+  const std::vector<double> z = redshifts();
+  const std::size_t nz = z.size();
+  const unsigned masks[] = { milia::Q_ALL, milia::Q_MODULUS | milia::Q_LT,
+      milia::Q_ANGULAR_SCALE | milia::Q_VOL };
+  for (int m = 0; m < 3; ++m)
+  {
+    std::vector<double> res(9 * NCOSMO * nz), ref(9 * nz);
+    milia::quantity_columns cols = milia::quantity_columns();
+    milia::quantity_columns rcols = milia::quantity_columns();
+    double** c[] = { &cols.dl, &cols.da, &cols.dm, &cols.dc, &cols.vol,
+        &cols.age, &cols.lt, &cols.modulus, &cols.angular_scale };
+    double** rc[] = { &rcols.dl, &rcols.da, &rcols.dm, &rcols.dc,
+        &rcols.vol, &rcols.age, &rcols.lt, &rcols.modulus,
+        &rcols.angular_scale };
+    for (int k = 0; k < 9; ++k)
+      if (masks[m] & (1u << k))
+      {
+        *c[k] = &res[k * NCOSMO * nz];
+        *rc[k] = &ref[k * nz];
+      }
+    ens.eval(&z[0], nz, masks[m], cols);
+    for (std::size_t i = 0; i < NCOSMO; ++i)
+    {
+      const milia::flrw metric(HUBBLE[i], MATTER[i], VACUUM[i]);
+      metric.eval(&z[0], nz, masks[m], rcols);
+      for (int k = 0; k < 9; ++k)
+        if (masks[m] & (1u << k))
+          for (std::size_t j = 0; j < nz; ++j)
+            assert_close((*rc[k])[j], (*c[k])[i * nz + j]);
+    }
+  }
+}
+
+void FlrwEnsembleTest::testHubbleThrows()
+{
+  const double hubble[] = { 70, 0 };
+  const double matter[] = { 0.3, 0.3 };
+  const double vacuum[] = { 0.7, 0.7 };
+  milia::flrw_ensemble ens(hubble, matter, vacuum, 2);
+}
+
+void FlrwEnsembleTest::testDensityThrows()
+{
+  const double hubble[] = { 70, 70 };
+  const double matter[] = { 0.3, -0.3 };
+  const double vacuum[] = { 0.7, 0.7 };
+  milia::flrw_ensemble ens(hubble, matter, vacuum, 2);
+}
+
+void FlrwEnsembleTest::testEmpty()
+{
+  const milia::flrw_ensemble none(HUBBLE, MATTER, VACUUM, 0);
+  CPPUNIT_ASSERT_EQUAL(std::size_t(0), none.size());
+  CPPUNIT_ASSERT_EQUAL(std::size_t(0), none.models());
+  const double z = 1;
+  double res = -1;
+  none.dl(&z, &res, 1);
+  CPPUNIT_ASSERT_EQUAL(-1., res);
+
+  const milia::flrw_ensemble ens = ensemble();
+  ens.eval(&z, 0, milia::Q_ALL, milia::quantity_columns());
+}
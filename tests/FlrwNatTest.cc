@@ -21,6 +21,8 @@
 #include "FlrwNatTest.h"
 #include "milia/flrw_nat.h"
 
+#include <cmath>
+
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(FlrwNatTest);
 
@@ -153,3 +155,216 @@ void FlrwNatTest::testComovingVolume() {
 		}
 	}
 }
+
+void FlrwNatTest::testArrays() {
+	const double z[] = {0.0, 0.001, 0.01, 0.1, 1, 3, 10, 1000};
+	const int nz = sizeof(z) / sizeof(z[0]);
+	double res[nz];
+	// The elliptic cases use other kernels in the array versions,
+	// at low z both lose some digits to cancellation
+	const double rtol = 1e-10;
+	// Number of lum_models
+	const int val = 7;
+	for (int j = 0; j < val; ++j) {
+		const milia::flrw_nat test00(lum_model[j][0], lum_model[j][1]);
+		test00.dl(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dl(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.da(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.da(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.dm(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dm(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.dc(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dc(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.vol(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.vol(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.age(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.age(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.lt(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.lt(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+	}
+}
+
+void FlrwNatTest::testInverse() {
+	const double z[] = {0.0, 0.001, 0.01, 0.1, 1, 3, 10, 1000};
+	const int nz = sizeof(z) / sizeof(z[0]);
+	double x[nz], res[nz];
+	const double rtol = 1e-9;
+	// Number of lum_models
+	const int val = 10;
+	for (int j = 0; j < val; ++j) {
+		const milia::flrw_nat test00(lum_model[j][0], lum_model[j][1]);
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.dl(z[i]);
+		test00.z_from_dl(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_dl(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.dc(z[i]);
+		test00.z_from_dc(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_dc(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.dm(z[i]);
+		test00.z_from_dm(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_dm(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.vol(z[i]);
+		test00.z_from_vol(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_vol(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+	}
+	// The ages of the A2 models are not checked in testAge,
+	// the times use the age_models
+	const int vala = 7;
+	for (int j = 0; j < vala; ++j) {
+		const milia::flrw_nat test00(age_model[j][0], age_model[j][1]);
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.lt(z[i]);
+		test00.z_from_lt(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_lt(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.age(z[i]);
+		test00.z_from_age(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_age(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+	}
+}
+
+void FlrwNatTest::testInverseNoRedshiftThrows() {
+	const milia::flrw_nat test00(0.3, 0.7);
+	test00.z_from_dc(10);
+}
+
+void FlrwNatTest::testInverseClosed() {
+	// dm, dc and vol have a maximum at the first z, dl at the second
+	// (0 if dl is increasing), past them the inverses return the lower
+	// redshift
+	const double model[][2] = { { 0.1, 1.1 }, { 0.1, 1.3 }, { 0.05, 1.15 },
+			{ 3, 0 }, { 2.5, 1 } };
+	const double turn[][2] = { { 6.94, 0 }, { 1.82, 2.14 }, { 3.17, 6.61 },
+			{ 22.3, 0 }, { 4.58, 0 } };
+	const double z[] = { 0.001, 0.1, 0.5, 0.9, 2, 3, 10, 100 };
+	const int nz = sizeof(z) / sizeof(z[0]);
+	const double rtol = 1e-9;
+	for (int j = 0; j < 5; ++j) {
+		const milia::flrw_nat test00(model[j][0], model[j][1]);
+		for (int i = 0; i < nz; ++i) {
+			const double dl = test00.dl(z[i]);
+			if (dl < 0)
+				continue;
+			const double zl = test00.z_from_dl(dl);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(dl, test00.dl(zl), rtol * dl);
+			if (turn[j][1] == 0 || z[i] < turn[j][1])
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], zl, rtol * (1 + z[i]));
+			const double dc = test00.dc(z[i]);
+			const double zc = test00.z_from_dc(dc);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(dc, test00.dc(zc), rtol * dc);
+			const double vol = test00.vol(z[i]);
+			const double zv = test00.z_from_vol(vol);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(vol, test00.vol(zv), rtol * vol);
+			if (z[i] < turn[j][0]) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], zc, rtol * (1 + z[i]));
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], zv, rtol * (1 + z[i]));
+			}
+			else
+				CPPUNIT_ASSERT(zc <= turn[j][0] && zv <= turn[j][0]);
+		}
+		// above the maximum of dl
+		if (turn[j][1] > 0) {
+			bool thrown = false;
+			try {
+				test00.z_from_dl(1.01 * test00.dl(turn[j][1]));
+			} catch (const std::domain_error&) {
+				thrown = true;
+			}
+			CPPUNIT_ASSERT(thrown);
+		}
+	}
+}
+
+void FlrwNatTest::testInverseExtreme() {
+	// one open model and three closed ones, the distances of the closed
+	// models have a maximum below z = 1000
+	const double model[][2] = { { 0.3, 0.5 }, { 2, 0.3 }, { 1.5, 0.2 },
+			{ 2.3, 0.15 } };
+	const double z[] = { 1e-7, 1e-6, 941, 1000 };
+	const int nz = sizeof(z) / sizeof(z[0]);
+	// at low z lt carries the rounding of the age over its own size
+	const double rtol_low = 1e-6;
+	const double rtol = 1e-9;
+	for (int j = 0; j < 4; ++j) {
+		const milia::flrw_nat test00(model[j][0], model[j][1]);
+		for (int i = 0; i < nz; ++i) {
+			const double tol = z[i] < 1 ? rtol_low * z[i] : rtol * (1 + z[i]);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i],
+					test00.z_from_lt(test00.lt(z[i])), tol);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i],
+					test00.z_from_age(test00.age(z[i])), tol);
+			if (j == 0 || z[i] < 1) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i],
+						test00.z_from_dl(test00.dl(z[i])), tol);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i],
+						test00.z_from_dc(test00.dc(z[i])), tol);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i],
+						test00.z_from_vol(test00.vol(z[i])), tol);
+			}
+		}
+	}
+}
+
+void FlrwNatTest::testSetParameters() {
+	milia::flrw_nat test00(0.3, 0.7);
+	const double z[] = { 0.1, 1, 3.5 };
+	// The current age is computed before the change
+	test00.age();
+	for (int j = 0; j < 7; ++j) {
+		test00.set_parameters(age_model[j][0], age_model[j][1]);
+		const milia::flrw_nat ref(age_model[j][0], age_model[j][1]);
+		CPPUNIT_ASSERT_EQUAL(ref.get_matter(), test00.get_matter());
+		CPPUNIT_ASSERT_EQUAL(ref.get_vacuum(), test00.get_vacuum());
+		CPPUNIT_ASSERT_EQUAL(ref.age(), test00.age());
+		for (int i = 0; i < 3; ++i) {
+			CPPUNIT_ASSERT_EQUAL(ref.dl(z[i]), test00.dl(z[i]));
+			CPPUNIT_ASSERT_EQUAL(ref.lt(z[i]), test00.lt(z[i]));
+		}
+	}
+}
+
+void FlrwNatTest::testSetParametersInvalid() {
+	milia::flrw_nat test00(0.3, 0.7);
+	const double age = test00.age();
+	const double invalid[][2] = { { 0.3, 2.5 }, { -1, 0.5 }, { 0.3, -0.1 } };
+	for (int j = 0; j < 3; ++j) {
+		bool thrown = false;
+		try {
+			test00.set_parameters(invalid[j][0], invalid[j][1]);
+		} catch (const std::domain_error&) {
+			thrown = true;
+		}
+		CPPUNIT_ASSERT(thrown);
+		CPPUNIT_ASSERT_EQUAL(0.3, test00.get_matter());
+		CPPUNIT_ASSERT_EQUAL(0.7, test00.get_vacuum());
+		CPPUNIT_ASSERT_EQUAL(age, test00.age());
+	}
+}
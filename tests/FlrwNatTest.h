@@ -41,6 +41,13 @@ class FlrwNatTest : public CppUnit::TestFixture, public FlrwTestDataMixin
     CPPUNIT_TEST(testComovingDistance);
     CPPUNIT_TEST(testAge);
     CPPUNIT_TEST(testComovingVolume);
+    CPPUNIT_TEST(testArrays);
+    CPPUNIT_TEST(testInverse);
+    CPPUNIT_TEST_EXCEPTION(testInverseNoRedshiftThrows, std::domain_error);
+    CPPUNIT_TEST(testInverseClosed);
+    CPPUNIT_TEST(testInverseExtreme);
+    CPPUNIT_TEST(testSetParameters);
+    CPPUNIT_TEST(testSetParametersInvalid);
     CPPUNIT_TEST_SUITE_END();
 public:
     void setUp();
@@ -73,6 +80,29 @@ public:
     void testAge();
 
     void testComovingVolume();
+
+    /** Checks the array methods against the scalar ones */
+    void testArrays();
+
+    /** Checks that the inverses recover the redshift */
+    void testInverse();
+
+    /** Tests a distance larger than the comoving distance at infinity */
+    void testInverseNoRedshiftThrows();
+
+    /** Checks the inverses of the closed models, where the distances
+     * have a maximum */
+    void testInverseClosed();
+
+    /** Checks the scalar inverses at very low and very high redshift,
+     * where lt and the age are differences of close values */
+    void testInverseExtreme();
+
+    /** Checks set_parameters against new objects */
+    void testSetParameters();
+
+    /** Checks that invalid parameters throw and leave the object unchanged */
+    void testSetParametersInvalid();
 };
 
 
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FlrwTTest.h"
+#include "milia/flrw_t.h"
+#include "milia/flrw.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const double RTOL = 1.0e-9;
+
+  void assert_close(double expected, double actual)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, RTOL * (1 + std::abs(
+        expected)));
+  }
+
+  // One cosmology of each case
+  const double MATTER[] = { 0, 0.3, 2, 1, 0, 0, 0.3, 0.3, 0.3, 3 };
+  const double VACUUM[] = { 0, 0, 0, 0, 0.5, 1, 0.7, 0.2, 0.8, 0.1 };
+  const char* MODELS[] = { "OM_OV_0", "OV_1", "OV_2", "OV_EDS", "OM",
+      "OM_DS", "OM_OV_1", "A1", "A1", "A2_2" };
+  const std::size_t NCOSMO = sizeof(MATTER) / sizeof(MATTER[0]);
+  const double HUBBLE = 70;
+
+  const double Z[] = { 0.01, 0.1, 0.5, 1, 2.5, 6 };
+  const std::size_t NZ = sizeof(Z) / sizeof(Z[0]);
+
+  struct model_name
+  {
+      typedef std::string result_type;
+      template<class Model>
+      std::string operator()(const milia::flrw_t<Model>& c) const
+      {
+        return c.model();
+      }
+  };
+
+  // Compares the scalar methods with milia::flrw
+  struct check_methods
+  {
+      typedef void result_type;
+      template<class Model>
+      void operator()(const milia::flrw_t<Model>& c) const
+      {
+        const milia::flrw ref(HUBBLE, c.get_matter(), c.get_vacuum());
+        for (std::size_t i = 0; i < NZ; ++i)
+        {
+          assert_close(ref.dl(Z[i]), c.dl(Z[i]));
+          assert_close(ref.dm(Z[i]), c.dm(Z[i]));
+          assert_close(ref.da(Z[i]), c.da(Z[i]));
+          assert_close(ref.dc(Z[i]), c.dc(Z[i]));
+          assert_close(ref.vol(Z[i]), c.vol(Z[i]));
+          assert_close(ref.DM(Z[i]), c.DM(Z[i]));
+          // the age of de Sitter's Universe is infinite, each
+          // class returns a different placeholder
+          if (Model::id != milia::impl::flrw_nat_model::OM_DS)
+            assert_close(ref.age(Z[i]), c.age(Z[i]));
+          assert_close(ref.lt(Z[i]), c.lt(Z[i]));
+        }
+      }
+  };
+
+  typedef void (milia::flrw_t<milia::model::flat_lcdm>::*array_method)(
+      const double*, double*, std::size_t) const;
+  typedef double (milia::flrw_t<milia::model::flat_lcdm>::*scalar_method)(
+      double) const;
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FlrwTTest);
+
+void FlrwTTest::setUp()
+{
+}
+
+void FlrwTTest::tearDown()
+{
+}
+
+void FlrwTTest::testFactory()
+{
+  for (std::size_t i = 0; i < NCOSMO; ++i)
+  {
+    const std::string name = milia::visit_flrw(HUBBLE, MATTER[i], VACUUM[i],
+        model_name());
+    CPPUNIT_ASSERT_EQUAL(std::string(MODELS[i]), name);
+    CPPUNIT_ASSERT_EQUAL(std::string(milia::rei::flrw_nat(MATTER[i],
+        VACUUM[i]).model()), name);
+  }
+}
+
+void FlrwTTest::testMethods()
+{
+  for (std::size_t i = 0; i < NCOSMO; ++i)
+    milia::visit_flrw(HUBBLE, MATTER[i], VACUUM[i], check_methods());
+}
+
+void FlrwTTest::testArrays()
+{
+  const milia::flrw_t<milia::model::flat_lcdm> c(HUBBLE, 0.3, 0.7);
+  const array_method arrays[] = { &milia::flrw_t<milia::model::flat_lcdm>::dl,
+      &milia::flrw_t<milia::model::flat_lcdm>::dm,
+      &milia::flrw_t<milia::model::flat_lcdm>::da,
+      &milia::flrw_t<milia::model::flat_lcdm>::dc,
+      &milia::flrw_t<milia::model::flat_lcdm>::vol,
+      &milia::flrw_t<milia::model::flat_lcdm>::age,
+      &milia::flrw_t<milia::model::flat_lcdm>::lt,
+      &milia::flrw_t<milia::model::flat_lcdm>::DM };
+  const scalar_method scalars[] = { &milia::flrw_t<milia::model::flat_lcdm>::dl,
+      &milia::flrw_t<milia::model::flat_lcdm>::dm,
+      &milia::flrw_t<milia::model::flat_lcdm>::da,
+      &milia::flrw_t<milia::model::flat_lcdm>::dc,
+      &milia::flrw_t<milia::model::flat_lcdm>::vol,
+      &milia::flrw_t<milia::model::flat_lcdm>::age,
+      &milia::flrw_t<milia::model::flat_lcdm>::lt,
+      &milia::flrw_t<milia::model::flat_lcdm>::DM };
+  std::vector<double> res(NZ);
+  for (std::size_t m = 0; m < sizeof(arrays) / sizeof(arrays[0]); ++m)
+  {
+    (c.*arrays[m])(Z, &res[0], NZ);
+    for (std::size_t i = 0; i < NZ; ++i)
+      assert_close((c.*scalars[m])(Z[i]), res[i]);
+  }
+
+  // the generic loop of the other models
+  const milia::flrw_t<milia::model::a1> a(HUBBLE, 0.3, 0.2);
+  a.dl(Z, &res[0], NZ);
+  for (std::size_t i = 0; i < NZ; ++i)
+    assert_close(a.dl(Z[i]), res[i]);
+}
+
+void FlrwTTest::testEval()
+{
+  const milia::flrw_t<milia::model::flat_lcdm> c(HUBBLE, 0.25, 0.75);
+  for (std::size_t i = 0; i < NZ; ++i)
+  {
+    milia::quantity_values v;
+    c.eval(Z[i], milia::Q_ALL, v);
+    assert_close(c.dl(Z[i]), v.dl);
+    assert_close(c.da(Z[i]), v.da);
+    assert_close(c.dm(Z[i]), v.dm);
+    assert_close(c.dc(Z[i]), v.dc);
+    assert_close(c.vol(Z[i]), v.vol);
+    assert_close(c.age(Z[i]), v.age);
+    assert_close(c.lt(Z[i]), v.lt);
+    assert_close(c.DM(Z[i]), v.modulus);
+  }
+}
+
+void FlrwTTest::testCaseThrows()
+{
+  milia::flrw_t<milia::model::flat_lcdm> c(HUBBLE, 0.3, 0.2);
+}
+
+void FlrwTTest::testHubbleThrows()
+{
+  milia::flrw_t<milia::model::eds> c(0, 1, 0);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_FLRW_T_TEST_H
+#define MILIA_FLRW_T_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <stdexcept>
+
+class FlrwTTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(FlrwTTest);
+    CPPUNIT_TEST(testFactory);
+    CPPUNIT_TEST(testMethods);
+    CPPUNIT_TEST(testArrays);
+    CPPUNIT_TEST(testEval);
+    CPPUNIT_TEST_EXCEPTION(testCaseThrows, std::domain_error);
+    CPPUNIT_TEST_EXCEPTION(testHubbleThrows, std::domain_error);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks that visit_flrw selects the model of rei::flrw_nat */
+    void testFactory();
+
+    /** Checks the scalar methods of every model against milia::flrw */
+    void testMethods();
+
+    /** Checks the array methods against the scalar ones */
+    void testArrays();
+
+    /** Checks eval against the scalar methods */
+    void testEval();
+
+    /** Checks that densities of other case throw */
+    void testCaseThrows();
+
+    /** Checks that a Hubble parameter <= 0 throws */
+    void testHubbleThrows();
+};
+
+#endif // MILIA_FLRW_T_TEST_H
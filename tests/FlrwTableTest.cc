@@ -0,0 +1,105 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FlrwTableTest.h"
+#include "milia/flrw_table.h"
+
+#include <cmath>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(FlrwTableTest);
+
+using milia::flrw;
+using milia::flrw_table;
+
+void FlrwTableTest::setUp() {
+}
+
+void FlrwTableTest::tearDown() {
+}
+
+void FlrwTableTest::testEmptyRangeThrows() {
+	const flrw_table test00(flrw(70, 0.3, 0.7), 1, 1);
+}
+
+void FlrwTableTest::testTolerance() {
+	const double rtol = 1e-10;
+	const int nz = 1000;
+	// Number of lum_models
+	const int val = 7;
+	for (int j = 0; j < val; ++j) {
+		const flrw exact(lum_model[j][0], lum_model[j][1], lum_model[j][2]);
+		const flrw_table test00(exact, 0, 20, rtol);
+		for (int i = 0; i < nz; ++i) {
+			// points that are not nodes
+			const double z = std::exp(0.0031 * i + 1e-4) - 1;
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.dl(z), test00.dl(z), 2 * rtol * std::abs(exact.dl(z)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.da(z), test00.da(z), 2 * rtol * std::abs(exact.da(z)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.dc(z), test00.dc(z), 2 * rtol * std::abs(exact.dc(z)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.vol(z), test00.vol(z), 2 * rtol * std::abs(exact.vol(z)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.age(z), test00.age(z), 2 * rtol * std::abs(exact.age(z)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.lt(z), test00.lt(z), 2 * rtol * std::abs(exact.lt(z)));
+		}
+	}
+}
+
+void FlrwTableTest::testUnreachableThrows() {
+	const flrw_table test00(flrw(70, 0.3, 0.2), 0, 20, 1e-14);
+}
+
+void FlrwTableTest::testOutOfRange() {
+	const flrw exact(70, 0.3, 0.7);
+	const flrw_table test00(exact, 0.5, 3, 1e-6);
+	const double z[] = {0.1, 10, 1000};
+	for (int i = 0; i < 3; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.dl(z[i]), test00.dl(z[i]), 1e-14 * exact.dl(z[i]));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(exact.age(z[i]), test00.age(z[i]), 1e-14 * exact.age(z[i]));
+	}
+}
+
+void FlrwTableTest::testArrays() {
+	const double z[] = {0, 0.001, 0.01, 0.1, 1, 3, 10, 1000};
+	const int nz = sizeof(z) / sizeof(z[0]);
+	double res[nz], dl[nz], vol[nz], lt[nz], modulus[nz];
+	const flrw_table test00(flrw(70, 0.3, 0.7), 0, 20);
+	test00.dl(z, res, nz);
+	for (int i = 0; i < nz; ++i)
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dl(z[i]), res[i], 1e-14 * res[i]);
+	test00.age(z, res, nz);
+	for (int i = 0; i < nz; ++i)
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.age(z[i]), res[i], 1e-14 * res[i]);
+	milia::quantity_columns cols = milia::quantity_columns();
+	cols.dl = dl;
+	cols.vol = vol;
+	cols.lt = lt;
+	cols.modulus = modulus;
+	test00.eval(z, nz, milia::Q_DL | milia::Q_VOL | milia::Q_LT | milia::Q_MODULUS, cols);
+	for (int i = 0; i < nz; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dl(z[i]), dl[i], 1e-14 * dl[i]);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.vol(z[i]), vol[i], 1e-14 * vol[i]);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.lt(z[i]), lt[i], 1e-14 * lt[i]);
+	}
+	// the modulus is -inf at z = 0
+	for (int i = 1; i < nz; ++i) {
+		milia::quantity_values r;
+		test00.eval(z[i], milia::Q_MODULUS, r);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(r.modulus, modulus[i], 1e-14 * std::abs(modulus[i]));
+	}
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_FLRW_TABLE_TEST_H
+#define MILIA_FLRW_TABLE_TEST_H
+
+#include "FlrwTestData.h"
+#include <stdexcept>
+#include <cppunit/extensions/HelperMacros.h>
+
+class FlrwTableTest : public CppUnit::TestFixture, public FlrwTestData
+{
+    CPPUNIT_TEST_SUITE(FlrwTableTest);
+    CPPUNIT_TEST_EXCEPTION(testEmptyRangeThrows, std::domain_error);
+    CPPUNIT_TEST(testTolerance);
+    CPPUNIT_TEST_EXCEPTION(testUnreachableThrows, std::runtime_error);
+    CPPUNIT_TEST(testOutOfRange);
+    CPPUNIT_TEST(testArrays);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Tests zmin = zmax */
+    void testEmptyRangeThrows();
+
+    /** Checks the tables against the exact methods inside the range */
+    void testTolerance();
+
+    /** Tests a tolerance below the accuracy of the exact methods */
+    void testUnreachableThrows();
+
+    /** Checks that the exact methods are used outside the range */
+    void testOutOfRange();
+
+    /** Checks the array methods and eval against the scalar ones */
+    void testArrays();
+};
+
+#endif // MILIA_FLRW_TABLE_TEST_H
@@ -21,6 +21,8 @@
 #include "FlrwTest.h"
 #include "milia/flrw.h"
 
+#include <cmath>
+
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(FlrwTest);
@@ -167,3 +169,151 @@ void FlrwTest::testComovingVolume() {
 		}
 	}
 }
+
+void FlrwTest::testArrays() {
+	const double z[] = {0.001, 0.01, 0.1, 1, 3, 10, 1000};
+	const int nz = sizeof(z) / sizeof(z[0]);
+	double res[nz];
+	// The elliptic cases use other kernels in the array versions,
+	// at low z both lose some digits to cancellation
+	const double rtol = 1e-10;
+	// Number of lum_models
+	const int val = 7;
+	for (int j = 0; j < val; ++j) {
+		const flrw test00(lum_model[j][0], lum_model[j][1],
+				lum_model[j][2]);
+		test00.dl(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dl(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.DM(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.DM(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.dc(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dc(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.vol(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.vol(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.age(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.age(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+		test00.lt(z, res, nz);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.lt(z[i]), res[i], rtol * (1 + std::abs(res[i])));
+	}
+}
+
+void FlrwTest::testEval() {
+	const double z[] = {0.001, 0.01, 0.1, 1, 3, 10, 1000};
+	const int nz = sizeof(z) / sizeof(z[0]);
+	double dl[nz], da[nz], dm[nz], dc[nz], vol[nz], age[nz], lt[nz];
+	double modulus[nz], angular_scale[nz];
+	const double rtol = 1e-10;
+	// Number of lum_models
+	const int val = 7;
+	for (int j = 0; j < val; ++j) {
+		const flrw test00(lum_model[j][0], lum_model[j][1],
+				lum_model[j][2]);
+		for (int i = 0; i < nz; ++i) {
+			milia::quantity_values r;
+			test00.eval(z[i], milia::Q_ALL, r);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dl(z[i]), r.dl, rtol * (1 + std::abs(r.dl)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.da(z[i]), r.da, rtol * (1 + std::abs(r.da)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dm(z[i]), r.dm, rtol * (1 + std::abs(r.dm)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dc(z[i]), r.dc, rtol * (1 + std::abs(r.dc)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.vol(z[i]), r.vol, rtol * (1 + std::abs(r.vol)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.age(z[i]), r.age, rtol * (1 + std::abs(r.age)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.lt(z[i]), r.lt, rtol * (1 + std::abs(r.lt)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.DM(z[i]), r.modulus, rtol * (1 + std::abs(r.modulus)));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.angular_scale(z[i]), r.angular_scale, rtol * (1 + std::abs(r.angular_scale)));
+		}
+		// Only the requested columns are written
+		milia::quantity_columns cols = milia::quantity_columns();
+		cols.dl = dl;
+		cols.da = da;
+		cols.dm = dm;
+		cols.dc = dc;
+		cols.vol = vol;
+		cols.age = age;
+		cols.lt = lt;
+		cols.modulus = modulus;
+		cols.angular_scale = angular_scale;
+		test00.eval(z, nz, milia::Q_ALL, cols);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dl(z[i]), dl[i], rtol * (1 + std::abs(dl[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.da(z[i]), da[i], rtol * (1 + std::abs(da[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dm(z[i]), dm[i], rtol * (1 + std::abs(dm[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dc(z[i]), dc[i], rtol * (1 + std::abs(dc[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.vol(z[i]), vol[i], rtol * (1 + std::abs(vol[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.age(z[i]), age[i], rtol * (1 + std::abs(age[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.lt(z[i]), lt[i], rtol * (1 + std::abs(lt[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.DM(z[i]), modulus[i], rtol * (1 + std::abs(modulus[i])));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.angular_scale(z[i]), angular_scale[i], rtol * (1 + std::abs(angular_scale[i])));
+		}
+		milia::quantity_columns only = milia::quantity_columns();
+		only.modulus = modulus;
+		test00.eval(z, nz, milia::Q_MODULUS, only);
+		for (int i = 0; i < nz; ++i)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.DM(z[i]), modulus[i], rtol * (1 + std::abs(modulus[i])));
+	}
+}
+
+void FlrwTest::testInverse() {
+	const double z[] = {0.001, 0.01, 0.1, 1, 3, 10, 1000};
+	const int nz = sizeof(z) / sizeof(z[0]);
+	double x[nz], res[nz];
+	const double rtol = 1e-9;
+	// Number of lum_models
+	const int val = 7;
+	for (int j = 0; j < val; ++j) {
+		const flrw test00(lum_model[j][0], lum_model[j][1],
+				lum_model[j][2]);
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.DM(z[i]);
+		test00.z_from_DM(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_DM(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.vol(z[i]);
+		test00.z_from_vol(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_vol(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+		for (int i = 0; i < nz; ++i)
+			x[i] = test00.lt(z[i]);
+		test00.z_from_lt(x, res, nz);
+		for (int i = 0; i < nz; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], test00.z_from_lt(x[i]), rtol * (1 + z[i]));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], rtol * (1 + z[i]));
+		}
+	}
+}
+
+void FlrwTest::testSetParameters() {
+	milia::flrw test00(70, 0.3, 0.7);
+	test00.set_parameters(0.25, 0.6, 65);
+	const milia::flrw ref(65, 0.25, 0.6);
+	CPPUNIT_ASSERT_EQUAL(ref.get_hubble(), test00.get_hubble());
+	CPPUNIT_ASSERT_EQUAL(ref.age(), test00.age());
+	CPPUNIT_ASSERT_EQUAL(ref.dl(2), test00.dl(2));
+	CPPUNIT_ASSERT_EQUAL(ref.lt(2), test00.lt(2));
+
+	// The natural-unit parameters alone
+	test00.set_parameters(0.3, 0.7);
+	CPPUNIT_ASSERT_EQUAL(65., test00.get_hubble());
+	CPPUNIT_ASSERT_EQUAL(milia::flrw(65, 0.3, 0.7).age(), test00.age());
+
+	// An invalid Hubble parameter leaves the densities unchanged
+	bool thrown = false;
+	try {
+		test00.set_parameters(0.25, 0.6, 0);
+	} catch (const std::domain_error&) {
+		thrown = true;
+	}
+	CPPUNIT_ASSERT(thrown);
+	CPPUNIT_ASSERT_EQUAL(0.3, test00.get_matter());
+	CPPUNIT_ASSERT_EQUAL(65., test00.get_hubble());
+}
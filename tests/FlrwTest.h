@@ -42,6 +42,10 @@ class FlrwTest : public CppUnit::TestFixture, public FlrwTestData
     CPPUNIT_TEST(testComovingDistance);
     CPPUNIT_TEST(testAge);
     CPPUNIT_TEST(testComovingVolume);
+    CPPUNIT_TEST(testArrays);
+    CPPUNIT_TEST(testEval);
+    CPPUNIT_TEST(testInverse);
+    CPPUNIT_TEST(testSetParameters);
     CPPUNIT_TEST_SUITE_END();
 public:
     void setUp();
@@ -84,6 +88,18 @@ public:
     void testAge();
 
     void testComovingVolume();
+
+    /** Checks the array methods against the scalar ones */
+    void testArrays();
+
+    /** Checks the fused evaluation against the individual methods */
+    void testEval();
+
+    /** Checks that the inverses recover the redshift */
+    void testInverse();
+
+    /** Checks set_parameters against new objects, and the Hubble check */
+    void testSetParameters();
 };
 
 
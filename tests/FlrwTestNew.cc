@@ -21,6 +21,10 @@
 #include "FlrwTestNew.h"
 #include "milia/flrw.h"
 
+#include <cmath>
+#include <string>
+#include <vector>
+
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION(FlrwTestNew);
 
@@ -160,3 +164,61 @@ void FlrwTestNew::testAge() {
                 }
         }
 }
+
+  void FlrwTestNew::testEval() {
+        const double z[] = {0.01, 0.1, 1, 3, 10};
+        const int nz = sizeof(z) / sizeof(z[0]);
+        const double rtol = 1e-12;
+        const int val = 7;
+        for (int j = 0; j < val; ++j) {
+          const flrw test00(lum_model[j][0], lum_model[j][1], lum_model[j][2]);
+          for (int i = 0; i < nz; ++i) {
+            milia::quantity_values r;
+            test00.eval(z[i], milia::Q_DL | milia::Q_DM | milia::Q_DC | milia::Q_VOL | milia::Q_AGE | milia::Q_LT, r);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dl(z[i]), r.dl, rtol * std::abs(r.dl));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dm(z[i]), r.dm, rtol * std::abs(r.dm));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.dc(z[i]), r.dc, rtol * std::abs(r.dc));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.vol(z[i]), r.vol, rtol * std::abs(r.vol));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.age(z[i]), r.age, rtol * std::abs(r.age));
+            // de Sitter's age is not finite, look-back time is not age(0) - age(z)
+            if (test00.age(0) > 0)
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(test00.age(0) - test00.age(z[i]), r.lt, rtol * test00.age(0));
+          }
+        }
+  }
+
+  void FlrwTestNew::testModels() {
+        const double models[][2] = {{0, 0}, {0.3, 0}, {2, 0}, {1, 0},
+                {0, 0.5}, {0, 1}, {0.3, 0.7}, {0.3, 0.2}, {3, 0.1}};
+        const char* names[] = {"OM_OV_0", "OV_1", "OV_2", "OV_EDS", "OM",
+                "OM_DS", "OM_OV_1", "A1", "A2_2"};
+        for (int j = 0; j < 9; ++j) {
+          const milia::rei::flrw_nat test00(models[j][0], models[j][1]);
+          CPPUNIT_ASSERT_EQUAL(std::string(names[j]), std::string(test00.model()));
+          CPPUNIT_ASSERT_EQUAL(models[j][0], test00.get_matter());
+          CPPUNIT_ASSERT_EQUAL(models[j][1], test00.get_vacuum());
+        }
+  }
+
+  void FlrwTestNew::testCopy() {
+        std::vector<milia::rei::flrw_nat> models;
+        std::vector<flrw> metrics;
+        for (int j = 0; j < 7; ++j) {
+          models.push_back(milia::rei::flrw_nat(lum_model[j][1], lum_model[j][2]));
+          metrics.push_back(flrw(lum_model[j][0], lum_model[j][1], lum_model[j][2]));
+        }
+        // Copies after the vector has grown and been assigned
+        std::vector<milia::rei::flrw_nat> copies(models.begin(), models.end());
+        copies = models;
+        for (int j = 0; j < 7; ++j) {
+          const milia::rei::flrw_nat test00(lum_model[j][1], lum_model[j][2]);
+          const flrw test01(lum_model[j][0], lum_model[j][1], lum_model[j][2]);
+          CPPUNIT_ASSERT_EQUAL(std::string(test00.model()), std::string(copies[j].model()));
+          for (double z = 0.01; z < 10; z *= 2) {
+            CPPUNIT_ASSERT_EQUAL(test00.dl(z), copies[j].dl(z));
+            CPPUNIT_ASSERT_EQUAL(test00.age(z), copies[j].age(z));
+            CPPUNIT_ASSERT_EQUAL(test00.vol(z), copies[j].vol(z));
+            CPPUNIT_ASSERT_EQUAL(test01.dl(z), metrics[j].dl(z));
+          }
+        }
+  }
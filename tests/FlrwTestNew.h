@@ -36,6 +36,9 @@ class FlrwTestNew : public CppUnit::TestFixture, public FlrwTestData
     CPPUNIT_TEST(testComovingVolume);
     CPPUNIT_TEST(testAge);
     CPPUNIT_TEST(testComovingTransverseDistance); 
+    CPPUNIT_TEST(testEval);
+    CPPUNIT_TEST(testModels);
+    CPPUNIT_TEST(testCopy);
     CPPUNIT_TEST_SUITE_END();
 public:
     void setUp();
@@ -51,6 +54,11 @@ public:
     void testAge();
     void testComovingTransverseDistance();
     void testAngularDistance();
+    void testEval();
+    /** Checks the model selected in each case */
+    void testModels();
+    /** Checks copies stored in a vector */
+    void testCopy();
 };
 
 
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "GridTest.h"
+#include "milia/grid.h"
+#include "milia/metric.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  // The scalar methods differ from the array versions in the last digits
+  const double RTOL = 1.0e-12;
+
+  // Valid cells and cells without Big Bang (0.3, 2.5), that
+  // recollapse (3, 0.1) or with negative densities
+  const double MATTER[] = { 0, 0.3, 1, 3, -0.1 };
+  const double VACUUM[] = { 0, 0.7, 0.1, 2.5, 1, -0.2 };
+  const std::size_t NM = sizeof(MATTER) / sizeof(MATTER[0]);
+  const std::size_t NV = sizeof(VACUUM) / sizeof(VACUUM[0]);
+  const double Z[] = { 0.1, 0.5, 1, 3 };
+  const std::size_t NZ = sizeof(Z) / sizeof(Z[0]);
+
+  // Cells that flrw_nat accepts
+  bool accepted(double om, double ov)
+  {
+    try
+    {
+      milia::flrw_nat(om, ov);
+    }
+    catch (const std::domain_error&)
+    {
+      return false;
+    }
+    return true;
+  }
+
+  // z fastest, as in a C array [NM][NV][NZ]
+  milia::grid_output output(std::vector<double>& buf)
+  {
+    buf.assign(NM * NV * NZ, 0);
+    const milia::grid_output res = { &buf[0], NV * NZ, NZ, 1 };
+    return res;
+  }
+
+  milia::grid_mask mask(std::vector<unsigned char>& buf)
+  {
+    buf.assign(NM * NV, 255);
+    const milia::grid_mask res = { &buf[0], NV, 1 };
+    return res;
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(GridTest);
+
+void GridTest::setUp()
+{
+}
+
+void GridTest::tearDown()
+{
+}
+
+void GridTest::testValues()
+{
+  std::vector<double> buf;
+  std::vector<unsigned char> flags;
+  milia::grid_eval(2, milia::Q_DL, 70, MATTER, NM, VACUUM, NV, Z, NZ,
+      output(buf), mask(flags));
+  for (std::size_t i = 0; i < NM; ++i)
+    for (std::size_t j = 0; j < NV; ++j)
+    {
+      if (flags[i * NV + j] != milia::GRID_VALID)
+        continue;
+      const milia::flrw metric(70, MATTER[i], VACUUM[j]);
+      for (std::size_t k = 0; k < NZ; ++k)
+      {
+        const double expected = metric.dl(Z[k]);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, buf[(i * NV + j) * NZ + k],
+            RTOL * std::abs(expected));
+      }
+    }
+}
+
+void GridTest::testNatural()
+{
+  std::vector<double> buf;
+  std::vector<unsigned char> flags;
+  milia::thread_pool pool(3);
+  milia::grid_eval(pool, milia::Q_AGE, 0, MATTER, NM, VACUUM, NV, Z, NZ,
+      output(buf), mask(flags));
+  for (std::size_t i = 0; i < NM; ++i)
+    for (std::size_t j = 0; j < NV; ++j)
+    {
+      if (flags[i * NV + j] != milia::GRID_VALID)
+        continue;
+      const milia::flrw_nat metric(MATTER[i], VACUUM[j]);
+      for (std::size_t k = 0; k < NZ; ++k)
+      {
+        const double expected = metric.age(Z[k]);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, buf[(i * NV + j) * NZ + k],
+            RTOL * std::abs(expected));
+      }
+    }
+}
+
+void GridTest::testMask()
+{
+  std::vector<double> buf;
+  std::vector<unsigned char> flags;
+  milia::grid_eval(1, milia::Q_LT, 0, MATTER, NM, VACUUM, NV, Z, NZ,
+      output(buf), mask(flags));
+  std::size_t valid = 0;
+  for (std::size_t i = 0; i < NM; ++i)
+    for (std::size_t j = 0; j < NV; ++j)
+    {
+      const double om = MATTER[i];
+      const double ov = VACUUM[j];
+      const unsigned char f = flags[i * NV + j];
+      if (f == milia::GRID_VALID)
+      {
+        ++valid;
+        CPPUNIT_ASSERT(accepted(om, ov));
+        CPPUNIT_ASSERT(!std::isnan(buf[(i * NV + j) * NZ]));
+      }
+      else
+        for (std::size_t k = 0; k < NZ; ++k)
+          CPPUNIT_ASSERT(std::isnan(buf[(i * NV + j) * NZ + k]));
+      CPPUNIT_ASSERT_EQUAL(!milia::check_bigbang(om, ov), bool(f
+          & milia::GRID_NO_BIGBANG));
+      if (om >= 0)
+        CPPUNIT_ASSERT_EQUAL(milia::check_recollapse(om, ov), bool(f
+            & milia::GRID_RECOLLAPSE));
+      else
+        CPPUNIT_ASSERT_EQUAL(int(milia::GRID_ERROR), int(f));
+    }
+  CPPUNIT_ASSERT(valid > NM);
+  CPPUNIT_ASSERT(flags[1 * NV + 3] & milia::GRID_NO_BIGBANG);
+  CPPUNIT_ASSERT(flags[3 * NV + 2] & milia::GRID_RECOLLAPSE);
+
+  // The mask is optional
+  const milia::grid_mask none = { 0, 0, 0 };
+  std::vector<double> again;
+  milia::grid_eval(1, milia::Q_LT, 0, MATTER, NM, VACUUM, NV, Z, NZ,
+      output(again), none);
+  for (std::size_t i = 0; i < buf.size(); ++i)
+    CPPUNIT_ASSERT(buf[i] == again[i] || (std::isnan(buf[i])
+        && std::isnan(again[i])));
+}
+
+void GridTest::testStrides()
+{
+  std::vector<double> ref;
+  std::vector<unsigned char> flags;
+  milia::grid_eval(2, milia::Q_DC, 0, MATTER, NM, VACUUM, NV, Z, NZ,
+      output(ref), mask(flags));
+
+  // z slowest, vacuum reversed
+  std::vector<double> buf(NM * NV * NZ);
+  const milia::grid_output res = { &buf[NV - 1], std::ptrdiff_t(NV),
+      -1, std::ptrdiff_t(NM * NV) };
+  milia::grid_eval(2, milia::Q_DC, 0, MATTER, NM, VACUUM, NV, Z, NZ, res,
+      mask(flags));
+  for (std::size_t i = 0; i < NM; ++i)
+    for (std::size_t j = 0; j < NV; ++j)
+      for (std::size_t k = 0; k < NZ; ++k)
+      {
+        const double expected = ref[(i * NV + j) * NZ + k];
+        const double actual = buf[k * NM * NV + i * NV + (NV - 1 - j)];
+        CPPUNIT_ASSERT(expected == actual || (std::isnan(expected)
+            && std::isnan(actual)));
+      }
+}
+
+void GridTest::testUndefined()
+{
+  // Without matter, vacuum > 1 has no computation case, and the de
+  // Sitter Universe (0, 1) has no age
+  const double matter[] = { 0 };
+  const double vacuum[] = { 0.5, 1, 1.015, 3 };
+  const std::size_t nv = sizeof(vacuum) / sizeof(vacuum[0]);
+  const milia::quantity q[] = { milia::Q_DL, milia::Q_AGE, milia::Q_LT };
+  for (std::size_t l = 0; l < 3; ++l)
+  {
+    std::vector<double> buf(nv * NZ);
+    std::vector<unsigned char> flags(nv, 255);
+    const milia::grid_output res = { &buf[0], std::ptrdiff_t(nv * NZ),
+        std::ptrdiff_t(NZ), 1 };
+    const milia::grid_mask m = { &flags[0], std::ptrdiff_t(nv), 1 };
+    milia::grid_eval(1, q[l], 0, matter, 1, vacuum, nv, Z, NZ, res, m);
+    for (std::size_t j = 0; j < nv; ++j)
+    {
+      const bool valid = vacuum[j] < 1 || (vacuum[j] == 1 && q[l]
+          != milia::Q_AGE);
+      CPPUNIT_ASSERT_EQUAL(int(valid ? milia::GRID_VALID
+          : milia::GRID_ERROR), int(flags[j]));
+      for (std::size_t k = 0; k < NZ; ++k)
+      {
+        const double v = buf[j * NZ + k];
+        if (valid)
+          CPPUNIT_ASSERT(v > 0);
+        else
+          CPPUNIT_ASSERT(std::isnan(v));
+      }
+    }
+  }
+}
+
+void GridTest::testQuantityThrows()
+{
+  std::vector<double> buf;
+  std::vector<unsigned char> flags;
+  milia::grid_eval(1, milia::quantity(milia::Q_DL | milia::Q_AGE), 70,
+      MATTER, NM, VACUUM, NV, Z, NZ, output(buf), mask(flags));
+}
+
+void GridTest::testNaturalThrows()
+{
+  std::vector<double> buf;
+  std::vector<unsigned char> flags;
+  milia::grid_eval(1, milia::Q_MODULUS, 0, MATTER, NM, VACUUM, NV, Z, NZ,
+      output(buf), mask(flags));
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_GRID_TEST_H
+#define MILIA_GRID_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <stdexcept>
+
+class GridTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(GridTest);
+    CPPUNIT_TEST(testValues);
+    CPPUNIT_TEST(testNatural);
+    CPPUNIT_TEST(testMask);
+    CPPUNIT_TEST(testStrides);
+    CPPUNIT_TEST(testUndefined);
+    CPPUNIT_TEST_EXCEPTION(testQuantityThrows, std::domain_error);
+    CPPUNIT_TEST_EXCEPTION(testNaturalThrows, std::domain_error);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks the valid cells against milia::flrw */
+    void testValues();
+
+    /** Checks the valid cells against milia::flrw_nat */
+    void testNatural();
+
+    /** Checks the flags and the values of the invalid cells */
+    void testMask();
+
+    /** Checks an output with negative and interleaved strides */
+    void testStrides();
+
+    /** Checks the empty Universes with vacuum >= 1 */
+    void testUndefined();
+
+    /** Checks that a mask of several quantities throws */
+    void testQuantityThrows();
+
+    /** Checks that the distance modulus throws in natural units */
+    void testNaturalThrows();
+};
+
+#endif // MILIA_GRID_TEST_H
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ParallelTest.h"
+#include "milia/metric.h"
+#include "milia/flrw_table.h"
+#include "milia/parallel.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  // Not a multiple of the chunk
+  std::vector<double> redshifts()
+  {
+    std::vector<double> z(3 * milia::PARALLEL_CHUNK + 77);
+    for (std::size_t i = 0; i < z.size(); ++i)
+      z[i] = std::exp(0.002 * i) - 1;
+    return z;
+  }
+
+  template<class Metric, class Base>
+  void check(milia::thread_pool& pool, const Metric& metric, void(Base::*method)(
+      const double*, double*, std::size_t) const, const std::vector<double>& z)
+  {
+    const std::size_t n = z.size();
+    std::vector<double> serial(n), par(n);
+    (metric.*method)(&z[0], &serial[0], n);
+    milia::parallel(pool, metric, method, &z[0], &par[0], n);
+    for (std::size_t i = 0; i < n; ++i)
+      CPPUNIT_ASSERT_EQUAL(serial[i], par[i]);
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelTest);
+
+void ParallelTest::setUp()
+{
+}
+
+void ParallelTest::tearDown()
+{
+}
+
+void ParallelTest::testSerialResults()
+{
+  const std::vector<double> z = redshifts();
+  const milia::flrw metric(70, 0.3, 0.7);
+  const milia::flrw open(70, 0.3, 0.2);
+  const milia::flrw_nat nat(0.3, 0.7);
+  const milia::flrw_table table(metric, 0, 20);
+  const unsigned sizes[] = { 1, 2, 3, 8 };
+  for (int s = 0; s < 4; ++s)
+  {
+    // The pool is reused for all the calls
+    milia::thread_pool pool(sizes[s]);
+    CPPUNIT_ASSERT_EQUAL(sizes[s], pool.size());
+    check(pool, metric, &milia::flrw::dl, z);
+    check(pool, metric, &milia::flrw::DM, z);
+    check(pool, metric, &milia::flrw::age, z);
+    check(pool, open, &milia::flrw::vol, z);
+    check(pool, open, &milia::flrw::lt, z);
+    check(pool, nat, &milia::flrw_nat::dc, z);
+    check(pool, table, &milia::flrw_table::dl, z);
+  }
+  // A new pool in the call
+  std::vector<double> serial(z.size()), par(z.size());
+  metric.da(&z[0], &serial[0], z.size());
+  milia::parallel(4, metric, &milia::flrw::da, &z[0], &par[0], z.size());
+  for (std::size_t i = 0; i < z.size(); ++i)
+    CPPUNIT_ASSERT_EQUAL(serial[i], par[i]);
+}
+
+void ParallelTest::testInverse()
+{
+  // The arrays of the inverses start from a table over the range
+  // of each chunk, the results agree to the tolerance of the inverse
+  const std::vector<double> z = redshifts();
+  const std::size_t n = z.size();
+  const milia::flrw metric(70, 0.3, 0.7);
+  std::vector<double> dl(n), res(n);
+  metric.dl(&z[0], &dl[0], n);
+  milia::thread_pool pool(4);
+  milia::parallel(pool, metric, &milia::flrw::z_from_dl, &dl[0], &res[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(z[i], res[i], 1e-10 * (1 + z[i]));
+}
+
+void ParallelTest::testErrorThrows()
+{
+  std::vector<double> dl(3 * milia::PARALLEL_CHUNK, 100.);
+  dl[milia::PARALLEL_CHUNK + 5] = -1;
+  std::vector<double> res(dl.size());
+  const milia::flrw metric(70, 0.3, 0.7);
+  milia::thread_pool pool(3);
+  milia::parallel(pool, metric, &milia::flrw::z_from_dl, &dl[0], &res[0],
+      dl.size());
+}
+
+void ParallelTest::testReuseAfterError()
+{
+  std::vector<double> dl(3 * milia::PARALLEL_CHUNK, 100.);
+  dl[milia::PARALLEL_CHUNK + 5] = -1;
+  std::vector<double> res(dl.size());
+  const milia::flrw metric(70, 0.3, 0.7);
+  milia::thread_pool pool(3);
+  bool thrown = false;
+  try
+  {
+    milia::parallel(pool, metric, &milia::flrw::z_from_dl, &dl[0], &res[0],
+        dl.size());
+  } catch (std::domain_error& e)
+  {
+    thrown = true;
+  }
+  CPPUNIT_ASSERT(thrown);
+  dl[milia::PARALLEL_CHUNK + 5] = 100;
+  milia::parallel(pool, metric, &milia::flrw::z_from_dl, &dl[0], &res[0],
+      dl.size());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(metric.z_from_dl(100.), res.back(), 1e-12);
+}
+
+void ParallelTest::testEmpty()
+{
+  const milia::flrw metric(70, 0.3, 0.7);
+  milia::thread_pool pool(2);
+  double z = 1, res = -1;
+  milia::parallel(pool, metric, &milia::flrw::dl, &z, &res, 0);
+  CPPUNIT_ASSERT_EQUAL(-1., res);
+}
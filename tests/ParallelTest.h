@@ -0,0 +1,58 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_PARALLEL_TEST_H
+#define MILIA_PARALLEL_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <stdexcept>
+
+class ParallelTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ParallelTest);
+    CPPUNIT_TEST(testSerialResults);
+    CPPUNIT_TEST(testInverse);
+    CPPUNIT_TEST_EXCEPTION(testErrorThrows, std::domain_error);
+    CPPUNIT_TEST(testReuseAfterError);
+    CPPUNIT_TEST(testEmpty);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks parallel calls against the serial array versions */
+    void testSerialResults();
+
+    /** Checks the inverse functions */
+    void testInverse();
+
+    /** Checks that an error in a chunk is thrown by parallel */
+    void testErrorThrows();
+
+    /** Checks that the pool works after an error */
+    void testReuseAfterError();
+
+    /** Checks an empty array */
+    void testEmpty();
+};
+
+#endif // MILIA_PARALLEL_TEST_H
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "QuadratureTest.h"
+#include "milia/quadrature.h"
+#include "milia/util.h"
+#include "milia/flrw_nat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  const double RTOL = 1.0e-12;
+
+  void assert_close(double expected, double actual, double tol)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, tol * std::abs(expected));
+  }
+
+  struct exponential
+  {
+      double operator()(double x) const
+      {
+        return std::exp(-x);
+      }
+  };
+
+  struct lorentzian
+  {
+      double operator()(double x) const
+      {
+        return 1 / (1 + x * x);
+      }
+  };
+
+  // Decays as x^-3/2, slower than the age of om = 0 models
+  struct power
+  {
+      double operator()(double x) const
+      {
+        return 1 / ((1 + x) * std::sqrt(1 + x));
+      }
+  };
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(QuadratureTest);
+
+void QuadratureTest::setUp()
+{
+}
+
+void QuadratureTest::tearDown()
+{
+}
+
+void QuadratureTest::testUpper()
+{
+  for (double a = -0.9; a < 300; a = 1.7 * a + 2)
+  {
+    assert_close(std::exp(-a), milia::quadrature::upper(exponential(), a,
+        RTOL), 10 * RTOL);
+    assert_close(2 * std::atan(1.) - std::atan(a), milia::quadrature::upper(lorentzian(), a,
+        RTOL), 10 * RTOL);
+    assert_close(2 / std::sqrt(1 + a), milia::quadrature::upper(power(), a,
+        RTOL), 10 * RTOL);
+  }
+}
+
+void QuadratureTest::testAge()
+{
+  // Flat and open models, with closed forms
+  const double models[][2] = { { 0.3, 0.7 }, { 1, 0 }, { 0.5, 0 },
+      { 0, 0.5 }, { 0.3, 0 } };
+  const double z[] = { 0, 0.1, 1, 10, 1000 };
+  for (int j = 0; j < 5; ++j)
+  {
+    const milia::flrw_nat m(models[j][0], models[j][1]);
+    const milia::age_integrand f = { models[j][0], models[j][1] };
+    for (int i = 0; i < 5; ++i)
+      assert_close(m.age(z[i]), milia::quadrature::upper(f, z[i], RTOL), 10
+          * RTOL);
+  }
+}
+
+void QuadratureTest::testArrays()
+{
+  // The size is not a multiple of the block width
+  std::vector<double> a;
+  for (double x = -0.5; x < 1e4; x = 1.3 * x + 0.7)
+    a.push_back(x);
+  std::vector<double> res(a.size());
+  const milia::age_integrand f = { 0.3, 0.7 };
+  milia::quadrature::upper(f, &a[0], &res[0], a.size(), RTOL);
+  for (std::size_t i = 0; i < a.size(); ++i)
+    assert_close(milia::quadrature::upper(f, a[i], RTOL), res[i], 10 * RTOL);
+
+  // In place
+  std::vector<double> tmp(a);
+  milia::quadrature::upper(f, &tmp[0], &tmp[0], tmp.size(), RTOL);
+  for (std::size_t i = 0; i < a.size(); ++i)
+    assert_close(res[i], tmp[i], 1e-15);
+}
+
+void QuadratureTest::testInterval()
+{
+  const double lims[][2] = { { 0, 1 }, { -0.9, 30 }, { 2, 0.5 }, { 3, 3 } };
+  for (int i = 0; i < 4; ++i)
+  {
+    const double a = lims[i][0];
+    const double b = lims[i][1];
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::exp(-a) - std::exp(-b),
+        milia::quadrature::interval(exponential(), a, b, RTOL), 10 * RTOL);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::atan(b) - std::atan(a),
+        milia::quadrature::interval(lorentzian(), a, b, RTOL), 10 * RTOL);
+  }
+}
+
+void QuadratureTest::testCumulative()
+{
+  // Increasing, decreasing, unsorted and with repeated limits
+  const double up[] = { 0, 0.1, 0.5, 1, 3, 10 };
+  const double down[] = { 10, 3, 1, 0.5, 0.1, 0 };
+  const double mixed[] = { 3, 0.1, 10, 0.5, 0.1, 0, 1 };
+  const double* xs[] = { up, down, mixed };
+  const std::size_t ns[] = { 6, 6, 7 };
+  for (int k = 0; k < 3; ++k)
+  {
+    std::vector<double> res(ns[k]);
+    milia::quadrature::cumulative(lorentzian(), -1, xs[k], &res[0], ns[k],
+        RTOL);
+    for (std::size_t i = 0; i < ns[k]; ++i)
+      assert_close(std::atan(xs[k][i]) + std::atan(1.), res[i], 10 * RTOL);
+
+    // In place
+    std::vector<double> tmp(xs[k], xs[k] + ns[k]);
+    milia::quadrature::cumulative(lorentzian(), -1, &tmp[0], &tmp[0],
+        ns[k], RTOL);
+    for (std::size_t i = 0; i < ns[k]; ++i)
+      assert_close(res[i], tmp[i], 1e-15);
+  }
+}
+
+void QuadratureTest::testCumulativeUpper()
+{
+  // Unsorted redshifts of a catalogue
+  std::vector<double> z;
+  for (double x = 0.01; x < 1e3; x = 1.3 * x + 0.02)
+    z.push_back(x);
+  for (std::size_t i = 0; i + 3 < z.size(); i += 4)
+    std::swap(z[i], z[i + 3]);
+  z.push_back(z[5]);
+  std::vector<double> res(z.size());
+  const milia::age_integrand f = { 0.3, 0.7 };
+  milia::quadrature::cumulative_upper(f, &z[0], &res[0], z.size(), RTOL);
+  for (std::size_t i = 0; i < z.size(); ++i)
+    assert_close(milia::quadrature::upper(f, z[i], RTOL), res[i], 10 * RTOL);
+
+  // In place
+  std::vector<double> tmp(z);
+  milia::quadrature::cumulative_upper(f, &tmp[0], &tmp[0], tmp.size(), RTOL);
+  for (std::size_t i = 0; i < z.size(); ++i)
+    assert_close(res[i], tmp[i], 1e-15);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_QUADRATURE_TEST_H
+#define MILIA_QUADRATURE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class QuadratureTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(QuadratureTest);
+    CPPUNIT_TEST(testUpper);
+    CPPUNIT_TEST(testAge);
+    CPPUNIT_TEST(testArrays);
+    CPPUNIT_TEST(testInterval);
+    CPPUNIT_TEST(testCumulative);
+    CPPUNIT_TEST(testCumulativeUpper);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks integrals in [a, inf) with closed forms */
+    void testUpper();
+
+    /** Checks the integral of the age against flrw_nat */
+    void testAge();
+
+    /** Checks the array version against the scalar one */
+    void testArrays();
+
+    /** Checks integrals in [a, b] with closed forms */
+    void testInterval();
+
+    /** Checks the cumulative integrals with limits in any order */
+    void testCumulative();
+
+    /** Checks the cumulative integrals in [a, inf) against upper */
+    void testCumulativeUpper();
+};
+
+#endif // MILIA_QUADRATURE_TEST_H
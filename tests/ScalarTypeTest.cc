@@ -0,0 +1,213 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ScalarTypeTest.h"
+#include "FlrwTestDataMixin.h"
+#include "milia/flrw_t.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // Relative accuracy of the flat models of each type
+  const double FLOAT_RTOL = 2e-6;
+  const double DOUBLE_RTOL = 1e-14;
+  // 80-bit long double, or double if they are the same type
+  const double LONG_DOUBLE_RTOL = std::max(2e-17,
+      100 * double(std::numeric_limits<long double>::epsilon()));
+  // The values of the tables at low z lost digits to cancellation,
+  // they are correct to about 1e-10 (the volume to 3e-10)
+  const double TABLE_RTOL = 5e-10;
+
+  // matter, z, dl, age of flat models, computed with 40 digits
+  const long double REFERENCE[][4] = {
+      { 0.05L, 0.001L, 0.00100096244028801749311L, 1.4889072923090277527L },
+      { 0.05L, 0.1L, 0.109562865924463691618L, 1.39496915008103084169L },
+      { 0.05L, 1.0L, 1.88064999444041101835L, 0.83264927224424548692L },
+      { 0.05L, 10.0L, 43.6054176027643366019L, 0.0815280058071640900169L },
+      { 0.05L, 1000.0L, 6381.8683746407301133L, 0.0000941396590754402326141L },
+      { 0.3L, 0.001L, 0.00100077472625872971753L, 0.963100106205153935685L },
+      { 0.3L, 0.1L, 0.107477672261299753377L, 0.87093968266829394627L },
+      { 0.3L, 1.0L, 1.54285413285562219004L, 0.411759550867871337001L },
+      { 0.3L, 10.0L, 24.2467481030766301758L, 0.033352798220000064278L },
+      { 0.3L, 1000.0L, 3192.85312986395128779L, 0.0000384323549888362726869L },
+      { 0.99L, 0.001L, 0.00100025736520348591576L, 0.667903559272816500707L },
+      { 0.99L, 0.1L, 0.102448564406087950298L, 0.580035166914879695145L },
+      { 0.99L, 1.0L, 1.17484250876905286961L, 0.236839862619554817442L },
+      { 0.99L, 10.0L, 15.4282806056241727594L, 0.0183654496816269483146L },
+      { 0.99L, 1000.0L, 1947.04392616005994596L, 0.0000211563151337583384349L },
+      { 0.9999L, 0.001L, 0.00100024994997821421081L, 0.665690138690847469758L },
+      { 0.9999L, 0.1L, 0.102382965434858707636L, 0.577877772962151535012L },
+      { 0.9999L, 1.0L, 1.17160540947804891536L, 0.235713555275213574546L },
+      { 0.9999L, 10.0L, 15.3673616899590424452L, 0.0182743283333144900136L },
+      { 0.9999L, 256.0L, 481.957987770656269651L, 0.000161819469010026214311L },
+      { 0.9999L, 1000.0L, 1938.80547376653087176L, 0.0000210513203659269515301L } };
+  const std::size_t NREFERENCE = sizeof(REFERENCE) / sizeof(REFERENCE[0]);
+
+  void assert_close(double expected, double actual, double rtol)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, rtol * std::abs(expected));
+  }
+
+  void assert_close(long double expected, long double actual, double rtol)
+  {
+    const long double diff = std::abs(actual - expected);
+    CPPUNIT_ASSERT(diff <= rtol * std::abs(expected));
+  }
+
+  typedef FlrwTestDataMixin data;
+
+  // Rows of the tables with flat models
+  template<class Model, class Quantity>
+  void check_table(const Model& m, const double table[5][3], Quantity q,
+      double rtol)
+  {
+    typedef typename Model::value_type T;
+    for (std::size_t i = 0; i < 5; ++i)
+      assert_close(table[i][0], q(m, T(table[i][1])), rtol);
+  }
+
+  struct lum
+  {
+      template<class Model>
+      double operator()(const Model& m, typename Model::value_type z) const
+      {
+        return m.dl(z);
+      }
+  };
+
+  struct ang
+  {
+      template<class Model>
+      double operator()(const Model& m, typename Model::value_type z) const
+      {
+        return milia::impl::da(m, z);
+      }
+  };
+
+  struct com
+  {
+      template<class Model>
+      double operator()(const Model& m, typename Model::value_type z) const
+      {
+        return milia::impl::dc(m, z);
+      }
+  };
+
+  struct vol
+  {
+      template<class Model>
+      double operator()(const Model& m, typename Model::value_type z) const
+      {
+        return milia::impl::vol(m, z);
+      }
+  };
+
+  struct age
+  {
+      template<class Model>
+      double operator()(const Model& m, typename Model::value_type z) const
+      {
+        return m.age(z);
+      }
+  };
+
+  template<class T>
+  void check_tables(double rtol)
+  {
+    using namespace milia::impl;
+    // lum_model[1], age_model[1] are (0.3, 0.7)
+    const basic_flrw_nat_OM_OV_1<T> lcdm(T(0.3));
+    check_table(lcdm, data::lum_table[1], lum(), rtol);
+    check_table(lcdm, data::age_table[1], age(), rtol);
+    // vol_model[3] is (0.27, 0.73)
+    check_table(basic_flrw_nat_OM_OV_1<T> (T(0.27)), data::vol_table[3],
+        vol(), rtol);
+    // lum_model[3] is de Sitter
+    check_table(basic_flrw_nat_OM_DS<T> (), data::lum_table[3], lum(), rtol);
+    // ang, cotran and com_model[0], vol_model[2] are Einstein-de Sitter
+    const basic_flrw_nat_OV_EDS<T> eds;
+    check_table(eds, data::ang_table[0], ang(), rtol);
+    check_table(eds, data::cotran_table[0], com(), rtol);
+    check_table(eds, data::com_table[0], com(), rtol);
+    check_table(eds, data::vol_table[2], vol(), rtol);
+  }
+
+  // The densities are those of the reference in T
+  // In float the error of 0.3f changes the distances by about 1e-8
+  template<class T>
+  void check_reference(double rtol)
+  {
+    for (std::size_t i = 0; i < NREFERENCE; ++i)
+    {
+      const milia::impl::basic_flrw_nat_OM_OV_1<T> m(T(REFERENCE[i][0]));
+      const T z = T(REFERENCE[i][1]);
+      assert_close(REFERENCE[i][2], (long double) m.dl(z), rtol);
+      assert_close(REFERENCE[i][3], (long double) m.age(z), rtol);
+    }
+  }
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ScalarTypeTest);
+
+void ScalarTypeTest::setUp()
+{
+}
+
+void ScalarTypeTest::tearDown()
+{
+}
+
+void ScalarTypeTest::testFloat()
+{
+  check_tables<float> (FLOAT_RTOL);
+  check_reference<float> (FLOAT_RTOL);
+}
+
+void ScalarTypeTest::testDouble()
+{
+  check_tables<double> (TABLE_RTOL);
+  check_reference<double> (DOUBLE_RTOL);
+}
+
+void ScalarTypeTest::testLongDouble()
+{
+  check_tables<long double> (TABLE_RTOL);
+  check_reference<long double> (LONG_DOUBLE_RTOL);
+}
+
+void ScalarTypeTest::testFlrwT()
+{
+  const milia::flrw_t<milia::model::flat_lcdm, float> f(70, 0.3, 0.7);
+  const milia::flrw_t<milia::model::flat_lcdm> d(70, 0.3, 0.7);
+  const float z[] = { 0.01f, 0.5f, 1, 3, 1000 };
+  float res[5];
+  f.dl(z, res, 5);
+  for (std::size_t i = 0; i < 5; ++i)
+  {
+    assert_close(d.dl(z[i]), f.dl(z[i]), FLOAT_RTOL);
+    assert_close(d.dl(z[i]), res[i], FLOAT_RTOL);
+    assert_close(d.age(z[i]), f.age(z[i]), FLOAT_RTOL);
+    assert_close(d.lt(z[i]), f.lt(z[i]), 10 * FLOAT_RTOL);
+  }
+}
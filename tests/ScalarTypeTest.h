@@ -0,0 +1,53 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_SCALAR_TYPE_TEST_H
+#define MILIA_SCALAR_TYPE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ScalarTypeTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ScalarTypeTest);
+    CPPUNIT_TEST(testFloat);
+    CPPUNIT_TEST(testDouble);
+    CPPUNIT_TEST(testLongDouble);
+    CPPUNIT_TEST(testFlrwT);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks the flat models in float against the tables and a reference */
+    void testFloat();
+
+    /** Checks the flat models in double against the tables and a reference */
+    void testDouble();
+
+    /** Checks the flat models in long double against the tables and a
+     * reference */
+    void testLongDouble();
+
+    /** Checks flrw_t in float against flrw_t in double */
+    void testFlrwT();
+};
+
+#endif // MILIA_SCALAR_TYPE_TEST_H
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StatsTest.h"
+#include "milia/flrw_nat.h"
+#include "milia/stats.h"
+
+#include <pthread.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Indices of the cases in milia::stats
+  const std::size_t OM_OV_1 = 6;
+  const std::size_t A1 = 7;
+
+  const double Z[] = { 0, 0.1, 0.5, 1, 2, 5, 10 };
+  const std::size_t NZ = sizeof(Z) / sizeof(Z[0]);
+
+  unsigned long long calls(std::size_t c, milia::stats::kernel k)
+  {
+    return milia::stats::snapshot().calls[c][k];
+  }
+
+  void* evaluate(void*)
+  {
+    const milia::flrw_nat m(0.3, 0.7);
+    for (std::size_t i = 0; i < NZ; ++i)
+      m.dl(Z[i]);
+    return 0;
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(StatsTest);
+
+void StatsTest::setUp()
+{
+  milia::stats::enable(false);
+  milia::stats::enable_timing(false);
+  milia::stats::reset();
+}
+
+void StatsTest::tearDown()
+{
+  milia::stats::enable(false);
+  milia::stats::enable_timing(false);
+}
+
+void StatsTest::testDisabled()
+{
+  CPPUNIT_ASSERT(!milia::stats::enabled());
+  const milia::flrw_nat m(0.3, 0.7);
+  std::vector<double> res(NZ);
+  m.dl(Z, &res[0], NZ);
+  m.age(Z[1]);
+  const milia::stats::counters c = milia::stats::snapshot();
+  const milia::stats::counters zero = milia::stats::counters();
+  CPPUNIT_ASSERT(std::memcmp(&c, &zero, sizeof(c)) == 0);
+}
+
+void StatsTest::testCalls()
+{
+  milia::stats::enable(true);
+  CPPUNIT_ASSERT(milia::stats::enabled());
+  const milia::flrw_nat m(0.3, 0.7);
+  std::vector<double> res(NZ);
+  for (std::size_t i = 0; i < NZ; ++i)
+    m.dl(Z[i]);
+  m.vol(Z, &res[0], NZ);
+  CPPUNIT_ASSERT_EQUAL(2ULL * NZ, calls(OM_OV_1, milia::stats::KERNEL_DL));
+  CPPUNIT_ASSERT_EQUAL(0ULL, calls(OM_OV_1, milia::stats::KERNEL_AGE));
+
+  const milia::flrw_nat a(0.3, 0.3);
+  a.lt(Z, &res[0], NZ);
+  a.age(Z[2]);
+  // lt also computes the current age, on first use
+  CPPUNIT_ASSERT_EQUAL(NZ + 2ULL, calls(A1, milia::stats::KERNEL_AGE));
+  CPPUNIT_ASSERT_EQUAL(0ULL, calls(A1, milia::stats::KERNEL_DL));
+  CPPUNIT_ASSERT_EQUAL(0ULL, milia::stats::snapshot().nanoseconds[A1][
+      milia::stats::KERNEL_AGE]);
+  CPPUNIT_ASSERT_EQUAL(std::string("A1"), std::string(
+      milia::stats::case_name(A1)));
+
+  // The densities without a computation case are not counted
+  const milia::flrw_nat none(0, 1.5);
+  none.dl(Z[1]);
+  none.age(Z, &res[0], NZ);
+  const milia::stats::counters c = milia::stats::snapshot();
+  unsigned long long total = 0;
+  for (std::size_t k = 0; k < milia::stats::NCASES; ++k)
+    total += c.calls[k][milia::stats::KERNEL_DL]
+        + c.calls[k][milia::stats::KERNEL_AGE];
+  CPPUNIT_ASSERT_EQUAL(2ULL * NZ + NZ + 2ULL, total);
+}
+
+void StatsTest::testPaths()
+{
+  milia::stats::enable(true);
+  // The age past the node of eq 10 uses the principal value
+  const milia::flrw_nat m(0.05, 0.86);
+  std::vector<double> res(NZ);
+  m.age(Z, &res[0], NZ);
+  for (std::size_t i = 0; i < NZ; ++i)
+    m.age(Z[i]);
+  milia::stats::counters c = milia::stats::snapshot();
+  CPPUNIT_ASSERT_EQUAL(2ULL * NZ, c.paths[milia::stats::PATH_A1_EQ10]
+      + c.paths[milia::stats::PATH_A1_PRINCIPAL]);
+  CPPUNIT_ASSERT(c.paths[milia::stats::PATH_A1_PRINCIPAL] > 0);
+  CPPUNIT_ASSERT_EQUAL(0ULL, c.paths[milia::stats::PATH_A1_NODE]);
+
+  // At the node, a short interval is integrated
+  const milia::flrw_nat n(0.3, 1.71);
+  n.age(7.9860105158918291);
+  c = milia::stats::snapshot();
+  CPPUNIT_ASSERT_EQUAL(1ULL, c.paths[milia::stats::PATH_A1_NODE]);
+  CPPUNIT_ASSERT_EQUAL(1ULL, c.intervals);
+
+  // The volume of non-flat models uses its series at low z
+  const milia::flrw_nat v(0.3, 0);
+  const double zv[] = { 1e-3, 1e-2, 10 };
+  v.vol(zv, &res[0], 3);
+  for (int i = 0; i < 3; ++i)
+    v.vol(zv[i]);
+  c = milia::stats::snapshot();
+  CPPUNIT_ASSERT_EQUAL(4ULL, c.paths[milia::stats::PATH_VOL_SERIES]);
+}
+
+void StatsTest::testReset()
+{
+  milia::stats::enable(true);
+  const milia::flrw_nat m(0.3, 0.7);
+  m.dl(1.);
+  CPPUNIT_ASSERT_EQUAL(1ULL, calls(OM_OV_1, milia::stats::KERNEL_DL));
+  milia::stats::reset();
+  CPPUNIT_ASSERT_EQUAL(0ULL, calls(OM_OV_1, milia::stats::KERNEL_DL));
+  m.dl(1.);
+  CPPUNIT_ASSERT_EQUAL(1ULL, calls(OM_OV_1, milia::stats::KERNEL_DL));
+
+  // Disabled, the counts are kept
+  milia::stats::enable(false);
+  m.dl(1.);
+  CPPUNIT_ASSERT_EQUAL(1ULL, calls(OM_OV_1, milia::stats::KERNEL_DL));
+}
+
+void StatsTest::testTiming()
+{
+  milia::stats::enable(true);
+  milia::stats::enable_timing(true);
+  CPPUNIT_ASSERT(milia::stats::timing());
+  const milia::flrw_nat m(0.3, 0.3);
+  std::vector<double> res(1000);
+  for (std::size_t i = 0; i < res.size(); ++i)
+    res[i] = 0.01 * i;
+  m.age(&res[0], &res[0], res.size());
+  CPPUNIT_ASSERT(milia::stats::snapshot().nanoseconds[A1][
+      milia::stats::KERNEL_AGE] > 0);
+  CPPUNIT_ASSERT_EQUAL(0ULL, milia::stats::snapshot().nanoseconds[A1][
+      milia::stats::KERNEL_DL]);
+}
+
+void StatsTest::testThreads()
+{
+  milia::stats::enable(true);
+  const int nthreads = 4;
+  pthread_t th[nthreads];
+  for (int i = 0; i < nthreads; ++i)
+    CPPUNIT_ASSERT(pthread_create(&th[i], 0, evaluate, 0) == 0);
+  for (int i = 0; i < nthreads; ++i)
+    pthread_join(th[i], 0);
+  evaluate(0);
+  CPPUNIT_ASSERT_EQUAL((nthreads + 1ULL) * NZ, calls(OM_OV_1,
+      milia::stats::KERNEL_DL));
+}
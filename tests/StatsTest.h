@@ -0,0 +1,60 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_STATS_TEST_H
+#define MILIA_STATS_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class StatsTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(StatsTest);
+    CPPUNIT_TEST(testDisabled);
+    CPPUNIT_TEST(testCalls);
+    CPPUNIT_TEST(testPaths);
+    CPPUNIT_TEST(testReset);
+    CPPUNIT_TEST(testTiming);
+    CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /** Checks that nothing is counted by default */
+    void testDisabled();
+
+    /** Checks the evaluations per case and kernel */
+    void testCalls();
+
+    /** Checks the paths of the age of A1 and of the volume */
+    void testPaths();
+
+    /** Checks that reset sets the counts to zero */
+    void testReset();
+
+    /** Checks that the kernels are timed only if enabled */
+    void testTiming();
+
+    /** Checks that the counts of finished threads are kept */
+    void testThreads();
+};
+
+#endif // MILIA_STATS_TEST_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ThreadTest.h"
+#include "milia/metric.h"
+#include "milia/flrw_table.h"
+
+#include <pthread.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+  const int NTHREADS = 8;
+  const int REPEATS = 20;
+
+  // Flat and non-flat models, the age of the last one uses
+  // the principal value of eq 10
+  const double models[][3] = { { 70, 0.3, 0.7 }, { 70, 0.3, 0 }, { 70, 0, 0.5 },
+      { 70, 1, 0 }, { 50, 0.3, 0.2 }, { 70, 0.05, 0.86 } };
+  const int NMODELS = sizeof(models) / sizeof(models[0]);
+
+  // Shared objects and their results
+  struct shared
+  {
+      std::vector<const milia::flrw*> metrics;
+      std::vector<const milia::rei::flrw*> reis;
+      std::vector<const milia::flrw_table*> tables;
+      std::vector<double> z;
+  };
+
+  std::vector<double> compute(const shared& s)
+  {
+    const std::size_t n = s.z.size();
+    std::vector<double> res;
+    std::vector<double> tmp(n);
+    for (std::size_t m = 0; m < s.metrics.size(); ++m)
+    {
+      const milia::flrw& f = *s.metrics[m];
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        res.push_back(f.dl(s.z[i]));
+        res.push_back(f.vol(s.z[i]));
+        res.push_back(f.age(s.z[i]));
+        res.push_back(f.lt(s.z[i]));
+        res.push_back(s.reis[m]->dl(s.z[i]));
+        res.push_back(s.reis[m]->age(s.z[i]));
+        res.push_back(s.tables[m]->dl(s.z[i]));
+        res.push_back(f.z_from_lt(f.lt(s.z[i])));
+      }
+      f.dl(&s.z[0], &tmp[0], n);
+      res.insert(res.end(), tmp.begin(), tmp.end());
+      f.age(&s.z[0], &tmp[0], n);
+      res.insert(res.end(), tmp.begin(), tmp.end());
+      s.tables[m]->age(&s.z[0], &tmp[0], n);
+      res.insert(res.end(), tmp.begin(), tmp.end());
+    }
+    return res;
+  }
+
+  struct task
+  {
+      const shared* s;
+      std::vector<double> res;
+  };
+
+  void* run(void* arg)
+  {
+    task* t = static_cast<task*> (arg);
+    for (int r = 0; r < REPEATS; ++r)
+      t->res = compute(*t->s);
+    return 0;
+  }
+
+  // First use of a new object
+  struct first_use
+  {
+      const milia::flrw* f;
+      const std::vector<double>* z;
+      std::vector<double> lt;
+      double age;
+  };
+
+  void* use(void* arg)
+  {
+    first_use* t = static_cast<first_use*> (arg);
+    t->lt.resize(t->z->size());
+    t->f->lt(&(*t->z)[0], &t->lt[0], t->lt.size());
+    t->age = t->f->age();
+    return 0;
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadTest);
+
+void ThreadTest::setUp()
+{
+}
+
+void ThreadTest::tearDown()
+{
+}
+
+void ThreadTest::testConcurrentConst()
+{
+  shared s;
+  for (int m = 0; m < NMODELS; ++m)
+  {
+    const milia::flrw* f = new milia::flrw(models[m][0], models[m][1],
+        models[m][2]);
+    s.metrics.push_back(f);
+    s.reis.push_back(new milia::rei::flrw(models[m][0], models[m][1],
+        models[m][2]));
+    s.tables.push_back(new milia::flrw_table(*f, 0, 10));
+  }
+  for (double z = 0.01; z < 20; z *= 1.3)
+    s.z.push_back(z);
+
+  const std::vector<double> serial = compute(s);
+
+  std::vector<task> tasks(NTHREADS);
+  std::vector<pthread_t> threads(NTHREADS);
+  for (int i = 0; i < NTHREADS; ++i)
+  {
+    tasks[i].s = &s;
+    CPPUNIT_ASSERT_EQUAL(0, pthread_create(&threads[i], 0, &run, &tasks[i]));
+  }
+  for (int i = 0; i < NTHREADS; ++i)
+    CPPUNIT_ASSERT_EQUAL(0, pthread_join(threads[i], 0));
+
+  // The same operations in the same order, the results are identical
+  for (int i = 0; i < NTHREADS; ++i)
+  {
+    CPPUNIT_ASSERT_EQUAL(serial.size(), tasks[i].res.size());
+    for (std::size_t j = 0; j < serial.size(); ++j)
+      CPPUNIT_ASSERT_EQUAL(serial[j], tasks[i].res[j]);
+  }
+
+  for (int m = 0; m < NMODELS; ++m)
+  {
+    delete s.metrics[m];
+    delete s.reis[m];
+    delete s.tables[m];
+  }
+}
+
+void ThreadTest::testConcurrentFirstUse()
+{
+  std::vector<double> z;
+  for (double x = 0.01; x < 20; x *= 1.3)
+    z.push_back(x);
+  for (int m = 0; m < NMODELS; ++m)
+    for (int r = 0; r < REPEATS; ++r)
+    {
+      const milia::flrw ref(models[m][0], models[m][1], models[m][2]);
+      std::vector<double> lt(z.size());
+      ref.lt(&z[0], &lt[0], z.size());
+
+      const milia::flrw f(models[m][0], models[m][1], models[m][2]);
+      std::vector<first_use> tasks(NTHREADS);
+      std::vector<pthread_t> threads(NTHREADS);
+      for (int i = 0; i < NTHREADS; ++i)
+      {
+        tasks[i].f = &f;
+        tasks[i].z = &z;
+        CPPUNIT_ASSERT_EQUAL(0, pthread_create(&threads[i], 0, &use, &tasks[i]));
+      }
+      for (int i = 0; i < NTHREADS; ++i)
+        CPPUNIT_ASSERT_EQUAL(0, pthread_join(threads[i], 0));
+
+      for (int i = 0; i < NTHREADS; ++i)
+      {
+        CPPUNIT_ASSERT_EQUAL(ref.age(), tasks[i].age);
+        for (std::size_t j = 0; j < z.size(); ++j)
+          CPPUNIT_ASSERT_EQUAL(lt[j], tasks[i].lt[j]);
+      }
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MILIA_THREAD_TEST_H
+#define MILIA_THREAD_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ThreadTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ThreadTest);
+    CPPUNIT_TEST(testConcurrentConst);
+    CPPUNIT_TEST(testConcurrentFirstUse);
+    CPPUNIT_TEST_SUITE_END();
+public:
+    void setUp();
+
+    void tearDown();
+
+    /**
+     * Calls the const methods of flrw, rei::flrw and flrw_table from
+     * several threads on shared objects, checks the serial results
+     */
+    void testConcurrentConst();
+
+    /**
+     * Calls age and lt from several threads on new objects, the
+     * current age is computed on first use
+     */
+    void testConcurrentFirstUse();
+};
+
+#endif // MILIA_THREAD_TEST_H
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2013 Sergio Pascual
+ *
+ * This file is part of Milia
+ *
+ * Milia is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Milia is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Milia.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "VmathTest.h"
+#include "milia/vmath.h"
+
+#include <cmath>
+
+#include <boost/math/special_functions/asinh.hpp>
+#include <boost/math/special_functions/atanh.hpp>
+#include <boost/math/special_functions/log1p.hpp>
+
+namespace
+{
+  // A few ulp
+  const double RTOL = 2.0e-15;
+
+  void assert_close(double expected, double actual)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, RTOL * std::abs(expected));
+  }
+}
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(VmathTest);
+
+void VmathTest::setUp()
+{
+}
+
+void VmathTest::tearDown()
+{
+}
+
+void VmathTest::testLog()
+{
+  for (double e = -300; e < 300; e += 0.737)
+  {
+    const double x = std::pow(10, e);
+    assert_close(std::log(x), milia::vmath::log(x));
+  }
+  for (double x = 0.013; x < 10; x += 0.0173)
+    assert_close(std::log(x), milia::vmath::log(x));
+  for (double x = -0.99; x < 10; x += 0.0173)
+    assert_close(boost::math::log1p(x), milia::vmath::log1p(x));
+  assert_close(boost::math::log1p(1e-10), milia::vmath::log1p(1e-10));
+}
+
+void VmathTest::testHyperbolic()
+{
+  for (double x = -0.999; x < 1; x += 0.00731)
+    assert_close(boost::math::atanh(x), milia::vmath::atanh(x));
+  for (double e = -10; e < 100; e += 0.137)
+  {
+    const double x = std::pow(10, e);
+    assert_close(boost::math::asinh(x), milia::vmath::asinh(x));
+    assert_close(-boost::math::asinh(x), milia::vmath::asinh(-x));
+  }
+}
+
+void VmathTest::testCircular()
+{
+  for (double e = -10; e < 100; e += 0.137)
+  {
+    const double x = std::pow(10, e);
+    assert_close(std::atan(x), milia::vmath::atan(x));
+    assert_close(-std::atan(x), milia::vmath::atan(-x));
+  }
+  for (double x = -1; x <= 1; x += 0.00731)
+  {
+    assert_close(std::asin(x), milia::vmath::asin(x));
+    assert_close(std::acos(x), milia::vmath::acos(x));
+  }
+  assert_close(std::asin(1.), milia::vmath::asin(1.));
+  assert_close(std::acos(-1.), milia::vmath::acos(-1.));
+  CPPUNIT_ASSERT_EQUAL(0.0, milia::vmath::acos(1.));
+}